@@ -44,7 +44,11 @@ extern "C" {
 /**
  * When filling in the desired audio spec structure,
  * - 'desired->freq' should be the desired audio frequency in samples-per-second.
- * - 'desired->format' should be the desired audio format.
+ * - 'desired->format' should be the desired audio format.  The hardware
+ *     is always opened with integer samples, so AUDIO_F32 is only passed
+ *     to the callback when SDL_OpenAudio() is given a NULL 'obtained' and
+ *     converts the audio itself.  Otherwise 'obtained->format' is the
+ *     integer format the callback gets.
  * - 'desired->samples' is the desired size of the audio buffer, in samples.
  *     This number should be a power of two, and may be adjusted by the audio
  *     driver to a value more suitable for the hardware.  Good values seem to
@@ -65,6 +69,8 @@ extern "C" {
  *     This function usually runs in a separate thread, and so you should
  *     protect data structures that it accesses by calling SDL_LockAudio()
  *     and SDL_UnlockAudio() in your code.
+ *     If it is NULL, the device is opened in push mode, and plays the data
+ *     you hand to SDL_PushAudio() instead.
  * - 'desired->userdata' is passed as the first parameter to your callback
  *     function.
  *
@@ -105,6 +111,9 @@ typedef struct SDL_AudioSpec {
 #define AUDIO_S16MSB	0x9010	/**< As above, but big-endian byte order */
 #define AUDIO_U16	AUDIO_U16LSB
 #define AUDIO_S16	AUDIO_S16LSB
+#define AUDIO_F32LSB	0x8120	/**< 32-bit floating point samples */
+#define AUDIO_F32MSB	0x9120	/**< As above, but big-endian byte order */
+#define AUDIO_F32	AUDIO_F32LSB
 
 /**
  *  @name Native audio byte ordering
@@ -113,9 +122,11 @@ typedef struct SDL_AudioSpec {
 #if SDL_BYTEORDER == SDL_LIL_ENDIAN
 #define AUDIO_U16SYS	AUDIO_U16LSB
 #define AUDIO_S16SYS	AUDIO_S16LSB
+#define AUDIO_F32SYS	AUDIO_F32LSB
 #else
 #define AUDIO_U16SYS	AUDIO_U16MSB
 #define AUDIO_S16SYS	AUDIO_S16MSB
+#define AUDIO_F32SYS	AUDIO_F32MSB
 #endif
 /*@}*/
 
@@ -195,6 +206,33 @@ extern DECLSPEC SDL_audiostatus SDLCALL SDL_GetAudioStatus(void);
  */
 extern DECLSPEC void SDLCALL SDL_PauseAudio(int pause_on);
 
+/**
+ * @name Audio Push Mode
+ * When the audio device is opened with a NULL callback, the audio thread
+ * plays data queued by SDL_PushAudio() from a lock-free ring buffer, and
+ * never has to wait for the application.  The ring holds 4 audio buffers,
+ * or as many as the SDL_AUDIO_PUSH_PERIODS environment variable says.
+ * Only one thread at a time may push audio.
+ */
+/*@{*/
+/**
+ * Queue 'len' bytes of audio in the format that was asked for when the
+ * device was opened.  Returns the number of bytes queued, which is less
+ * than 'len' if the ring buffer is full, or -1 if the device isn't open
+ * in push mode.
+ */
+extern DECLSPEC int SDLCALL SDL_PushAudio(const void *data, Uint32 len);
+
+/** Get the number of bytes queued and not yet played */
+extern DECLSPEC Uint32 SDLCALL SDL_GetPushedAudioSize(void);
+
+/**
+ * Get the number of audio buffers that ran out of queued data while
+ * playing, and were padded with silence
+ */
+extern DECLSPEC Uint32 SDLCALL SDL_GetAudioUnderruns(void);
+/*@}*/
+
 /**
  * This function loads a WAVE from the data source, automatically freeing
  * that source if 'freesrc' is non-zero.  For example, to load a WAVE file,
@@ -223,6 +261,20 @@ extern DECLSPEC SDL_AudioSpec * SDLCALL SDL_LoadWAV_RW(SDL_RWops *src, int frees
  */
 extern DECLSPEC void SDLCALL SDL_FreeWAV(Uint8 *audio_buf);
 
+/**
+ * This function opens a WAVE from the data source for streaming, and
+ * returns a new data source that reads the decoded audio, in the format
+ * it fills in 'spec' with.  Unlike SDL_LoadWAV_RW(), the audio is read
+ * and decoded a block at a time as it is needed, and the data source
+ * can seek to any point of the decoded audio.  The WAVE data source is
+ * closed along with the new one if 'freesrc' is non-zero.
+ *
+ * The result can be given to SDL_PlayVoiceRW() to play music without
+ * loading all of it into memory.  This function returns NULL and sets
+ * the SDL error message if the WAVE can't be decoded.
+ */
+extern DECLSPEC SDL_RWops * SDLCALL SDL_RWFromWAV(SDL_RWops *src, int freesrc, SDL_AudioSpec *spec);
+
 /**
  * This function takes a source format and rate and a destination format
  * and rate, and initializes the 'cvt' structure with information needed
@@ -254,9 +306,48 @@ extern DECLSPEC int SDLCALL SDL_ConvertAudio(SDL_AudioCVT *cvt);
  * The volume ranges from 0 - 128, and should be set to SDL_MIX_MAXVOLUME
  * for full audio volume.  Note this does not change hardware volume.
  * This is provided for convenience -- you can mix your own audio data.
+ * AUDIO_F32 samples are clipped to the range -1.0 to 1.0.
  */
 extern DECLSPEC void SDLCALL SDL_MixAudio(Uint8 *dst, const Uint8 *src, Uint32 len, int volume);
 
+/**
+ * @name Voice Mixer
+ * SDL can mix any number of voices into the audio stream itself, after
+ * the callback (or the data pushed with SDL_PushAudio()) has filled it.
+ * Voices are mixed in the format, channel count and rate of the desired
+ * audio spec, as it would be passed to the callback.  'spec' gives the
+ * format, channels and rate of the voice data, or is NULL if the data
+ * is already in the mixing format.  Each function returns a voice id
+ * greater than 0, or -1 on error.
+ * 'loops' is the number of times the voice repeats after it first
+ * ends, or -1 to repeat until it is stopped.
+ */
+/*@{*/
+/**
+ * Play 'len' bytes of memory, such as a buffer from SDL_LoadWAV().
+ * The memory must stay valid until the voice has ended.  Data in any
+ * other format or rate than the mixing one is converted to a copy
+ * when the voice starts, and the memory can be freed right away.
+ */
+extern DECLSPEC int SDLCALL SDL_PlayVoice(const Uint8 *data, Uint32 len, const SDL_AudioSpec *spec, int loops);
+/**
+ * Stream a voice from the current position of a data source.  The data
+ * source is read from the audio thread, and closed when the voice ends
+ * if 'freesrc' is non-zero.  Streamed data isn't converted, so this
+ * fails if 'spec' doesn't match the mixing format, channels and rate.
+ */
+extern DECLSPEC int SDLCALL SDL_PlayVoiceRW(SDL_RWops *src, int freesrc, const SDL_AudioSpec *spec, int loops);
+/**
+ * Set the volume (0 - SDL_MIX_MAXVOLUME) and pan (-128 for left only to
+ * 128 for right only) of a voice.  Returns 0, or -1 if it has ended.
+ */
+extern DECLSPEC int SDLCALL SDL_SetVoiceGain(int voice, int volume, int pan);
+/** Returns 1 if the voice is still playing, 0 if it has ended */
+extern DECLSPEC int SDLCALL SDL_VoicePlaying(int voice);
+/** Stop a voice early */
+extern DECLSPEC void SDLCALL SDL_StopVoice(int voice);
+/*@}*/
+
 /**
  * @name Audio Locks
  * The lock manipulated by these functions protects the callback function.
@@ -135,6 +135,7 @@
 #define HAVE_SA_SIGACTION 1
 #define HAVE_SETJMP 1
 #define HAVE_NANOSLEEP 1
+#define HAVE_MMAP 1
 /* #undef HAVE_CLOCK_GETTIME */
 #define HAVE_GETPAGESIZE 1
 #define HAVE_MPROTECT 1
@@ -295,6 +295,13 @@ extern DECLSPEC int SDLCALL SDL_WaitEvent(SDL_Event *event);
  */
 extern DECLSPEC int SDLCALL SDL_PushEvent(SDL_Event *event);
 
+/** Returns the number of events dropped because the event queue was full
+ *  since the event loop was started.  The queue grows as needed up to 4096
+ *  events, or the number given in the SDL_EVENT_QUEUE_SIZE environment
+ *  variable.
+ */
+extern DECLSPEC Uint32 SDLCALL SDL_GetDroppedEvents(void);
+
 /** @name Event Filtering */
 /*@{*/
 typedef int (SDLCALL *SDL_EventFilter)(const SDL_Event *event);
@@ -105,6 +105,25 @@ extern DECLSPEC SDL_RWops * SDLCALL SDL_RWFromFP(FILE *fp, int autoclose);
 extern DECLSPEC SDL_RWops * SDLCALL SDL_RWFromMem(void *mem, int size);
 extern DECLSPEC SDL_RWops * SDLCALL SDL_RWFromConstMem(const void *mem, int size);
 
+/**
+ * Open a file read-only by mapping it into memory, so that it is paged
+ * in lazily and can be decoded in place through SDL_RWGetMemory().
+ * Where mmap() isn't available, or the file can't be mapped, this
+ * returns the same stream as SDL_RWFromFile(file, "rb").
+ */
+extern DECLSPEC SDL_RWops * SDLCALL SDL_RWFromFileMapped(const char *file);
+
+/**
+ * Get a direct view of the data left in a memory backed stream, that is
+ * one from SDL_RWFromMem(), SDL_RWFromConstMem() or SDL_RWFromFileMapped().
+ * The view starts at the current read point and *size is set to the
+ * number of bytes up to the end.  It stays valid until the stream is
+ * closed and must not be written to.
+ *
+ * @return The view, or NULL if the stream isn't backed by memory
+ */
+extern DECLSPEC const Uint8 * SDLCALL SDL_RWGetMemory(SDL_RWops *context, int *size);
+
 extern DECLSPEC SDL_RWops * SDLCALL SDL_AllocRW(void);
 extern DECLSPEC void SDLCALL SDL_FreeRW(SDL_RWops *area);
 
@@ -51,6 +51,26 @@ extern DECLSPEC Uint32 SDLCALL SDL_GetTicks(void);
 /** Wait a specified number of milliseconds before returning */
 extern DECLSPEC void SDLCALL SDL_Delay(Uint32 ms);
 
+/**
+ * Get the current value of a high resolution counter.
+ * It counts SDL_GetPerformanceFrequency() units per second and is only
+ * meaningful relative to other values of the counter, for example to time
+ * frames or profile code.  The counter is monotonic wherever the system
+ * has a monotonic clock; elsewhere it follows the wall clock.  Platforms
+ * without a finer clock count milliseconds.
+ */
+extern DECLSPEC Uint64 SDLCALL SDL_GetPerformanceCounter(void);
+
+/** Get the number of SDL_GetPerformanceCounter() units per second */
+extern DECLSPEC Uint64 SDLCALL SDL_GetPerformanceFrequency(void);
+
+/**
+ * Wait a specified number of nanoseconds before returning.
+ * The bulk of the wait is spent asleep, the last fraction of a millisecond
+ * is spun off so the wait ends close to the requested time.
+ */
+extern DECLSPEC void SDLCALL SDL_DelayNS(Uint64 ns);
+
 /** Function prototype for the timer callback function */
 typedef Uint32 (SDLCALL *SDL_TimerCallback)(Uint32 interval);
 
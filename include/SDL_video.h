@@ -157,6 +157,11 @@ typedef struct SDL_Surface {
 
 /*@}*/
 
+/** @name SDL_BlitSurfaceBatch() flags */
+/*@{*/
+#define SDL_BATCH_SORTROWS	0x00000001	/**< Reorder blits by destination row */
+/*@}*/
+
 /** Evaluates to true if the surface needs to be locked before access */
 #define SDL_MUSTLOCK(surface)	\
   (surface->offset ||		\
@@ -755,6 +760,27 @@ extern DECLSPEC int SDLCALL SDL_LowerBlit
 			(SDL_Surface *src, SDL_Rect *srcrect,
 			 SDL_Surface *dst, SDL_Rect *dstrect);
 
+/**
+ * Blit 'n' rectangles of one surface to another in a single call, as if
+ * SDL_BlitSurface() was called for each pair of rectangles in turn, but
+ * the blit mapping is checked and the surfaces are locked only once.
+ * If 'srcrects' is NULL, the whole source surface is blitted each time.
+ * Each of the 'dstrects' is clipped and updated like the destination
+ * rectangle of SDL_BlitSurface().
+ *
+ * With SDL_BATCH_SORTROWS in 'flags' the blits are reordered by
+ * destination row, which is friendlier to the cache when drawing many
+ * tiles.  Only use it when the destination rectangles don't overlap,
+ * since it changes which blit ends up on top.
+ *
+ * This function returns 0 on success, or -1 (or -2 for lost video
+ * memory, see SDL_BlitSurface()) on error.
+ */
+extern DECLSPEC int SDLCALL SDL_BlitSurfaceBatch
+			(SDL_Surface *src, SDL_Rect *srcrects,
+			 SDL_Surface *dst, SDL_Rect *dstrects,
+			 int n, Uint32 flags);
+
 /**
  * This function performs a fast fill of the given rectangle with 'color'
  * The given rectangle is clipped to the destination surface clip area
@@ -121,6 +121,72 @@ SDL_AudioDevice *current_audio = NULL;
 int SDL_AudioInit(const char *driver_name);
 void SDL_AudioQuit(void);
 
+/* Push mode hands data between threads with acquire/release ordering */
+#if defined(__GNUC__) && ((__GNUC__ > 4) || ((__GNUC__ == 4) && (__GNUC_MINOR__ >= 7)))
+#define SDL_AUDIO_PUSH	1
+#define PUSH_LOAD(x)		__atomic_load_n(&(x), __ATOMIC_ACQUIRE)
+#define PUSH_STORE(x, v)	__atomic_store_n(&(x), (v), __ATOMIC_RELEASE)
+#endif
+
+#define PUSH_PERIODS	4	/* Default ring size, in audio buffers */
+
+#if SDL_AUDIO_PUSH
+/* The callback of push mode, drains the ring buffer into the stream */
+static void SDLCALL SDL_PullAudio(void *userdata, Uint8 *stream, int len)
+{
+	SDL_AudioDevice *audio = (SDL_AudioDevice *)userdata;
+	Uint32 head, tail, avail, offset, chunk;
+
+	tail = audio->push_tail;
+	head = PUSH_LOAD(audio->push_head);
+	avail = head - tail;
+	if ( avail < (Uint32)len ) {
+		PUSH_STORE(audio->push_underruns, audio->push_underruns+1);
+		SDL_memset(stream+avail, audio->push_silence, len-avail);
+		len = avail;
+	}
+
+	offset = tail & (audio->push_size-1);
+	chunk = audio->push_size - offset;
+	if ( chunk > (Uint32)len ) {
+		chunk = len;
+	}
+	SDL_memcpy(stream, audio->push_buf+offset, chunk);
+	SDL_memcpy(stream+chunk, audio->push_buf, len-chunk);
+	PUSH_STORE(audio->push_tail, tail+len);
+}
+
+static int SDL_AllocPushBuffer(SDL_AudioDevice *audio, SDL_AudioSpec *spec,
+                               Uint32 period)
+{
+	const char *env;
+	Uint32 periods, size;
+
+	periods = PUSH_PERIODS;
+	env = SDL_getenv("SDL_AUDIO_PUSH_PERIODS");
+	if ( env && (SDL_atoi(env) > 1) ) {
+		periods = SDL_atoi(env);
+	}
+	size = 1;
+	while ( size < periods*period ) {
+		size *= 2;
+	}
+
+	audio->push_buf = (Uint8 *)SDL_malloc(size);
+	if ( audio->push_buf == NULL ) {
+		SDL_OutOfMemory();
+		return(-1);
+	}
+	audio->push_size = size;
+	audio->push_frame = ((spec->format & 0xFF) / 8) * spec->channels;
+	audio->push_silence = spec->silence;
+	audio->push_head = 0;
+	audio->push_tail = 0;
+	audio->push_underruns = 0;
+	return(0);
+}
+#endif /* SDL_AUDIO_PUSH */
+
 /* The general mixing thread function */
 int SDLCALL SDL_RunAudio(void *audiop)
 {
@@ -194,9 +260,21 @@ int SDLCALL SDL_RunAudio(void *audiop)
 		SDL_memset(stream, silence, stream_len);
 
 		if ( ! audio->paused ) {
-			SDL_mutexP(audio->mixer_lock);
-			(*fill)(udata, stream, stream_len);
-			SDL_mutexV(audio->mixer_lock);
+			if ( audio->push_buf ) {
+				/* Push mode never waits for the application,
+				   unless it has voices playing as well */
+				(*fill)(udata, stream, stream_len);
+				if ( audio->playing_voices ) {
+					SDL_mutexP(audio->mixer_lock);
+					SDL_MixVoices(audio, stream, stream_len);
+					SDL_mutexV(audio->mixer_lock);
+				}
+			} else {
+				SDL_mutexP(audio->mixer_lock);
+				(*fill)(udata, stream, stream_len);
+				SDL_MixVoices(audio, stream, stream_len);
+				SDL_mutexV(audio->mixer_lock);
+			}
 		}
 
 		/* Convert the audio if necessary */
@@ -255,6 +333,7 @@ static void SDL_UnlockAudio_Default(SDL_AudioDevice *audio)
 static Uint16 SDL_ParseAudioFormat(const char *string)
 {
 	Uint16 format = 0;
+	int bits;
 
 	switch (*string) {
 	    case 'U':
@@ -265,17 +344,31 @@ static Uint16 SDL_ParseAudioFormat(const char *string)
 		++string;
 		format |= 0x8000;
 		break;
+	    case 'F':
+		++string;
+		format |= 0x8100;
+		break;
 	    default:
 		return 0;
 	}
-	switch (SDL_atoi(string)) {
+	bits = SDL_atoi(string);
+	if ( (format & 0x0100) && (bits != 32) ) {
+		/* Floating point samples are always 32-bit */
+		return 0;
+	}
+	switch (bits) {
 	    case 8:
 		string += 1;
 		format |= 8;
 		break;
+	    case 32:
+		if ( !(format & 0x0100) ) {
+			return 0;
+		}
+		/* Fall through to the byte order */
 	    case 16:
 		string += 2;
-		format |= 16;
+		format |= bits;
 		if ( SDL_strcmp(string, "LSB") == 0
 #if SDL_BYTEORDER == SDL_LIL_ENDIAN
 		     || SDL_strcmp(string, "SYS") == 0
@@ -398,6 +491,7 @@ int SDL_OpenAudio(SDL_AudioSpec *desired, SDL_AudioSpec *obtained)
 {
 	SDL_AudioDevice *audio;
 	const char *env;
+	int push;
 
 	/* Start up the audio driver, if necessary */
 	if ( ! current_audio ) {
@@ -469,9 +563,14 @@ int SDL_OpenAudio(SDL_AudioSpec *desired, SDL_AudioSpec *obtained)
 		}
 		desired->samples = power2;
 	}
+	push = 0;
 	if ( desired->callback == NULL ) {
+#if SDL_AUDIO_PUSH
+		push = 1;
+#else
 		SDL_SetError("SDL_OpenAudio() passed a NULL callback");
 		return(-1);
+#endif
 	}
 
 #if SDL_THREADS_DISABLED
@@ -491,6 +590,18 @@ int SDL_OpenAudio(SDL_AudioSpec *desired, SDL_AudioSpec *obtained)
 
 	/* Open the audio subsystem */
 	SDL_memcpy(&audio->spec, desired, sizeof(audio->spec));
+	if ( audio->spec.format & 0x0100 ) {
+		/* The drivers only deal in integer samples, float audio
+		   is converted to native 16-bit on the way out */
+		audio->spec.format = AUDIO_S16SYS;
+		SDL_CalculateAudioSpec(&audio->spec);
+	}
+#if SDL_AUDIO_PUSH
+	if ( push ) {
+		audio->spec.callback = SDL_PullAudio;
+		audio->spec.userdata = audio;
+	}
+#endif
 	audio->convert.needed = 0;
 	audio->enabled = 1;
 	audio->paused  = 1;
@@ -519,6 +630,10 @@ int SDL_OpenAudio(SDL_AudioSpec *desired, SDL_AudioSpec *obtained)
 	/* See if we need to do any conversion */
 	if ( obtained != NULL ) {
 		SDL_memcpy(obtained, &audio->spec, sizeof(audio->spec));
+		if ( push ) {
+			obtained->callback = NULL;
+			obtained->userdata = desired->userdata;
+		}
 	} else if ( desired->freq != audio->spec.freq ||
                     desired->format != audio->spec.format ||
 	            desired->channels != audio->spec.channels ) {
@@ -534,6 +649,20 @@ int SDL_OpenAudio(SDL_AudioSpec *desired, SDL_AudioSpec *obtained)
 		if ( audio->convert.needed ) {
 			audio->convert.len = (int) ( ((double) audio->spec.size) /
                                           audio->convert.len_ratio );
+			if ( audio->convert.rate_incr != 0.0 ) {
+				/* Resampling: whole frames in, and exactly one
+				   device buffer out of every call */
+				int frame = ((desired->format & 0xFF) / 8) *
+				            desired->channels;
+				double ratio = audio->convert.len_ratio;
+				audio->convert.len = ((audio->convert.len +
+				            frame/2) / frame) * frame;
+				audio->convert.len_ratio =
+				   (double)audio->spec.size / audio->convert.len;
+				audio->convert.rate_incr *=
+				   ratio / audio->convert.len_ratio;
+				audio->rate_carry = 0;
+			}
 			audio->convert.buf =(Uint8 *)SDL_AllocAudioMem(
 			   audio->convert.len*audio->convert.len_mult);
 			if ( audio->convert.buf == NULL ) {
@@ -544,6 +673,36 @@ int SDL_OpenAudio(SDL_AudioSpec *desired, SDL_AudioSpec *obtained)
 		}
 	}
 
+	/* Voices are mixed into the stream the callback sees */
+	if ( audio->convert.needed ) {
+		audio->voice_format = desired->format;
+		audio->voice_channels = desired->channels;
+		audio->voice_freq = desired->freq;
+	} else {
+		audio->voice_format = audio->spec.format;
+		audio->voice_channels = audio->spec.channels;
+		audio->voice_freq = audio->spec.freq;
+	}
+
+#if SDL_AUDIO_PUSH
+	/* Pushed data is in the format the callback would have seen */
+	if ( push ) {
+		int failed;
+
+		if ( audio->convert.needed ) {
+			failed = SDL_AllocPushBuffer(audio, desired,
+			                             audio->convert.len);
+		} else {
+			failed = SDL_AllocPushBuffer(audio, &audio->spec,
+			                             audio->spec.size);
+		}
+		if ( failed < 0 ) {
+			SDL_CloseAudio();
+			return(-1);
+		}
+	}
+#endif
+
 	/* Start the audio thread if necessary */
 	switch (audio->opened) {
 		case  1:
@@ -594,6 +753,65 @@ void SDL_PauseAudio (int pause_on)
 	}
 }
 
+int SDL_PushAudio(const void *data, Uint32 len)
+{
+#if SDL_AUDIO_PUSH
+	SDL_AudioDevice *audio = current_audio;
+	Uint32 head, tail, space, offset, chunk;
+
+	if ( ! audio || ! audio->push_buf ) {
+		SDL_SetError("Audio device isn't open in push mode");
+		return(-1);
+	}
+
+	head = audio->push_head;
+	tail = PUSH_LOAD(audio->push_tail);
+	space = audio->push_size - (head - tail);
+	if ( len > space ) {
+		len = space;
+	}
+	/* Never queue part of a sample frame */
+	len -= len % audio->push_frame;
+
+	offset = head & (audio->push_size-1);
+	chunk = audio->push_size - offset;
+	if ( chunk > len ) {
+		chunk = len;
+	}
+	SDL_memcpy(audio->push_buf+offset, data, chunk);
+	SDL_memcpy(audio->push_buf, (const Uint8 *)data+chunk, len-chunk);
+	PUSH_STORE(audio->push_head, head+len);
+	return((int)len);
+#else
+	SDL_SetError("Audio push mode isn't supported on this platform");
+	return(-1);
+#endif
+}
+
+Uint32 SDL_GetPushedAudioSize(void)
+{
+#if SDL_AUDIO_PUSH
+	SDL_AudioDevice *audio = current_audio;
+
+	if ( audio && audio->push_buf ) {
+		return(PUSH_LOAD(audio->push_head) - PUSH_LOAD(audio->push_tail));
+	}
+#endif
+	return(0);
+}
+
+Uint32 SDL_GetAudioUnderruns(void)
+{
+#if SDL_AUDIO_PUSH
+	SDL_AudioDevice *audio = current_audio;
+
+	if ( audio && audio->push_buf ) {
+		return(PUSH_LOAD(audio->push_underruns));
+	}
+#endif
+	return(0);
+}
+
 void SDL_LockAudio (void)
 {
 	SDL_AudioDevice *audio = current_audio;
@@ -634,6 +852,11 @@ void SDL_AudioQuit(void)
 		if ( audio->fake_stream != NULL ) {
 			SDL_FreeAudioMem(audio->fake_stream);
 		}
+		if ( audio->push_buf != NULL ) {
+			SDL_free(audio->push_buf);
+			audio->push_buf = NULL;
+		}
+		SDL_FreeVoices(audio);
 		if ( audio->convert.needed ) {
 			SDL_FreeAudioMem(audio->convert.buf);
 
@@ -24,6 +24,7 @@
 /* Functions for audio drivers to perform runtime conversion of audio format */
 
 #include "SDL_audio.h"
+#include "SDL_sysaudio.h"
 
 
 /* Effectively mix right and left channels into a single channel */
@@ -856,6 +857,74 @@ void SDLCALL SDL_ConvertEndian(SDL_AudioCVT *cvt, Uint16 format)
 	}
 }
 
+/* Convert 32-bit float to native signed 16-bit */
+static __inline__ Sint32 SDL_FloatToS16(float sample)
+{
+	if ( sample >= 1.0f ) {
+		return(32767);
+	}
+	if ( sample <= -1.0f ) {
+		return(-32768);
+	}
+	return((Sint32)(sample * 32768.0f));
+}
+
+void SDLCALL SDL_ConvertFromFloat(SDL_AudioCVT *cvt, Uint16 format)
+{
+	int i;
+	union { Uint32 u; float f; } sample;
+	const Uint32 *src;
+	Sint16 *dst;
+
+#ifdef DEBUG_CONVERT
+	fprintf(stderr, "Converting from float\n");
+#endif
+	src = (const Uint32 *)cvt->buf;
+	dst = (Sint16 *)cvt->buf;
+	for ( i=cvt->len_cvt/4; i; --i ) {
+		sample.u = *src++;
+		if ( (format & 0x1000) == 0x1000 ) {
+			sample.u = SDL_SwapBE32(sample.u);
+		} else {
+			sample.u = SDL_SwapLE32(sample.u);
+		}
+		*dst++ = (Sint16)SDL_FloatToS16(sample.f);
+	}
+	format = AUDIO_S16SYS;
+	cvt->len_cvt /= 2;
+	if ( cvt->filters[++cvt->filter_index] ) {
+		cvt->filters[cvt->filter_index](cvt, format);
+	}
+}
+
+/* Convert native signed 16-bit to 32-bit float in the destination order */
+void SDLCALL SDL_ConvertToFloat(SDL_AudioCVT *cvt, Uint16 format)
+{
+	int i;
+	union { Uint32 u; float f; } sample;
+	const Sint16 *src;
+	Uint32 *dst;
+
+#ifdef DEBUG_CONVERT
+	fprintf(stderr, "Converting to float\n");
+#endif
+	src = (const Sint16 *)(cvt->buf+cvt->len_cvt);
+	dst = (Uint32 *)(cvt->buf+cvt->len_cvt*2);
+	for ( i=cvt->len_cvt/2; i; --i ) {
+		sample.f = (float)*--src * (1.0f / 32768.0f);
+		if ( (cvt->dst_format & 0x1000) == 0x1000 ) {
+			*--dst = SDL_SwapBE32(sample.u);
+		} else {
+			*--dst = SDL_SwapLE32(sample.u);
+		}
+	}
+	format = cvt->dst_format;
+	cvt->len_cvt *= 2;
+	if ( cvt->filters[++cvt->filter_index] ) {
+		cvt->filters[cvt->filter_index](cvt, format);
+	}
+}
+
 /* Convert rate up by multiple of 2 */
 void SDLCALL SDL_RateMUL2(SDL_AudioCVT *cvt, Uint16 format)
 {
@@ -1226,80 +1295,352 @@ void SDLCALL SDL_RateDIV2_c6(SDL_AudioCVT *cvt, Uint16 format)
 }
 
 /* Very slow rate conversion routine */
-void SDLCALL SDL_RateSLOW(SDL_AudioCVT *cvt, Uint16 format)
+static __inline__ Sint32 SDL_RateRead(const Uint8 *src, int size, int swap,
+                                      Uint16 flip)
 {
-	double ipos;
-	int i, clen;
+	if ( size == 1 ) {
+		return (Sint8)(*src ^ flip);
+	} else {
+		Uint16 raw = *(const Uint16 *)src;
+		if ( swap ) {
+			raw = SDL_Swap16(raw);
+		}
+		return (Sint16)(raw ^ flip);
+	}
+}
 
-#ifdef DEBUG_CONVERT
-	fprintf(stderr, "Converting audio rate * %4.4f\n", 1.0/cvt->rate_incr);
-#endif
-	clen = (int)((double)cvt->len_cvt / cvt->rate_incr);
-	if ( cvt->rate_incr > 1.0 ) {
-		switch (format & 0xFF) {
-			case 8: {
-				Uint8 *output;
-
-				output = cvt->buf;
-				ipos = 0.0;
-				for ( i=clen; i; --i ) {
-					*output = cvt->buf[(int)ipos];
-					ipos += cvt->rate_incr;
-					output += 1;
-				}
-			}
-			break;
+static __inline__ void SDL_RateWrite(Uint8 *dst, int size, int swap,
+                                     Uint16 flip, Sint32 value)
+{
+	if ( size == 1 ) {
+		*dst = (Uint8)value ^ (Uint8)flip;
+	} else {
+		Uint16 raw = (Uint16)value ^ flip;
+		if ( swap ) {
+			raw = SDL_Swap16(raw);
+		}
+		*(Uint16 *)dst = raw;
+	}
+}
 
-			case 16: {
-				Uint16 *output;
+/* Linear interpolation from N input frames to M = N/rate_incr output
+   frames.  Output frame j is taken at input position (j+1)*N/M - 1, so the
+   last output frame lands on the last input frame.  The audio device
+   converts one continuous stream, so there the first output frame
+   interpolates from the last frame of the previous call, and chunk edges
+   don't click.  Other conversions start from their own first frame.
+ */
+static void SDL_RateResample(SDL_AudioCVT *cvt, Uint16 format, int channels)
+{
+	SDL_AudioDevice *audio = current_audio;
+	Sint32 *carry, last[6], value;
+	Uint8 *buf;
+	int size, frame, swap;
+	Uint16 flip;
+	int i, j, c, N, M;
+	Sint64 pos;
+
+	size = (format & 0xFF) / 8;
+	frame = size * channels;
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+	swap = ((format & 0x1000) != 0);
+#else
+	swap = ((format & 0x1000) == 0);
+#endif
+	/* Unsigned samples are made signed by flipping the top bit */
+	flip = (format & 0x8000) ? 0 : ((size == 1) ? 0x80 : 0x8000);
+
+	buf = cvt->buf;
+	N = cvt->len_cvt / frame;
+	M = (int)((double)N / cvt->rate_incr + 0.5);
+	if ( (N <= 0) || (M <= 0) ) {
+		cvt->len_cvt = 0;
+		goto done;
+	}
 
-				clen &= ~1;
-				output = (Uint16 *)cvt->buf;
-				ipos = 0.0;
-				for ( i=clen/2; i; --i ) {
-					*output=((Uint16 *)cvt->buf)[(int)ipos];
-					ipos += cvt->rate_incr;
-					output += 1;
-				}
-			}
-			break;
+	/* Pick up where the device's last call left off */
+	carry = NULL;
+	if ( audio && (cvt == &audio->convert) ) {
+		carry = audio->rate_last;
+	}
+	for ( c=0; c<channels; ++c ) {
+		if ( carry && audio->rate_carry ) {
+			last[c] = carry[c];
+		} else {
+			last[c] = SDL_RateRead(buf + c*size, size, swap, flip);
 		}
-	} else {
-		switch (format & 0xFF) {
-			case 8: {
-				Uint8 *output;
-
-				output = cvt->buf+clen;
-				ipos = (double)cvt->len_cvt;
-				for ( i=clen; i; --i ) {
-					ipos -= cvt->rate_incr;
-					output -= 1;
-					*output = cvt->buf[(int)ipos];
-				}
-			}
-			break;
+	}
 
-			case 16: {
-				Uint16 *output;
+	/* Save this call's last frame before it's overwritten */
+	if ( carry ) {
+		for ( c=0; c<channels; ++c ) {
+			carry[c] = SDL_RateRead(buf + (N-1)*frame + c*size,
+			                        size, swap, flip);
+		}
+		audio->rate_carry = 1;
+	}
 
-				clen &= ~1;
-				output = (Uint16 *)(cvt->buf+clen);
-				ipos = (double)cvt->len_cvt/2;
-				for ( i=clen/2; i; --i ) {
-					ipos -= cvt->rate_incr;
-					output -= 1;
-					*output=((Uint16 *)cvt->buf)[(int)ipos];
-				}
-			}
-			break;
+#define RATE_FRAME(j) { \
+	pos = (((Sint64)(j+1) * N) << 16) / M - 0x10000; \
+	i = (int)(pos >> 16); \
+	for ( c=0; c<channels; ++c ) { \
+		Sint32 a, b, f = (Sint32)(pos & 0xFFFF) >> 1; \
+		a = (i < 0) ? last[c] : \
+		    SDL_RateRead(buf + i*frame + c*size, size, swap, flip); \
+		b = (i+1 < N) ? \
+		    SDL_RateRead(buf + (i+1)*frame + c*size, size, swap, flip) : a; \
+		/* A 15-bit fraction keeps 16-bit steps in range */ \
+		value = a + (((b - a) * f) >> 15); \
+		SDL_RateWrite(buf + (j)*frame + c*size, size, swap, flip, value); \
+	} \
+}
+	/* Work in place: up from the back, down from the front, so the
+	   frames still to be read are never overwritten
+	 */
+	if ( M > N ) {
+		for ( j=M-1; j>=0; --j ) {
+			RATE_FRAME(j);
+		}
+	} else {
+		for ( j=0; j<M; ++j ) {
+			RATE_FRAME(j);
 		}
 	}
-	cvt->len_cvt = clen;
+#undef RATE_FRAME
+	cvt->len_cvt = M * frame;
+
+done:
 	if ( cvt->filters[++cvt->filter_index] ) {
 		cvt->filters[cvt->filter_index](cvt, format);
 	}
 }
 
+void SDLCALL SDL_RateSLOW(SDL_AudioCVT *cvt, Uint16 format)
+{
+#ifdef DEBUG_CONVERT
+	fprintf(stderr, "Converting audio rate * %4.4f\n", 1.0/cvt->rate_incr);
+#endif
+	SDL_RateResample(cvt, format, 1);
+}
+
+void SDLCALL SDL_RateSLOW_c2(SDL_AudioCVT *cvt, Uint16 format)
+{
+#ifdef DEBUG_CONVERT
+	fprintf(stderr, "Converting audio rate * %4.4f (two channels)\n", 1.0/cvt->rate_incr);
+#endif
+	SDL_RateResample(cvt, format, 2);
+}
+
+void SDLCALL SDL_RateSLOW_c4(SDL_AudioCVT *cvt, Uint16 format)
+{
+#ifdef DEBUG_CONVERT
+	fprintf(stderr, "Converting audio rate * %4.4f (four channels)\n", 1.0/cvt->rate_incr);
+#endif
+	SDL_RateResample(cvt, format, 4);
+}
+
+void SDLCALL SDL_RateSLOW_c6(SDL_AudioCVT *cvt, Uint16 format)
+{
+#ifdef DEBUG_CONVERT
+	fprintf(stderr, "Converting audio rate * %4.4f (six channels)\n", 1.0/cvt->rate_incr);
+#endif
+	SDL_RateResample(cvt, format, 6);
+}
+
+/* Fused conversion kernels.
+   The common format and channel changes are done by one specialized
+   pass instead of a chain of filters that each walk the whole buffer.
+   Every sample is widened to signed 16-bit, mixed or duplicated, and
+   stored in the destination format.  The _x2 variants also fold in the
+   first rate doubling.
+*/
+#define FUSED_SIZE_U8		1
+#define FUSED_SIZE_S8		1
+#define FUSED_SIZE_S16LSB	2
+#define FUSED_SIZE_S16MSB	2
+
+#define FUSED_READ_U8(p)	(((Sint32)(p)[0] - 128) * 256)
+#define FUSED_READ_S8(p)	((Sint32)(Sint8)(p)[0] * 256)
+#define FUSED_READ_S16LSB(p)	((Sint32)(Sint16)(((p)[1] << 8) | (p)[0]))
+#define FUSED_READ_S16MSB(p)	((Sint32)(Sint16)(((p)[0] << 8) | (p)[1]))
+
+#define FUSED_WRITE_U8(p, v)	(p)[0] = (Uint8)(((v) >> 8) + 128)
+#define FUSED_WRITE_S16LSB(p, v) \
+	{ (p)[0] = (Uint8)(v); (p)[1] = (Uint8)((v) >> 8); }
+#define FUSED_WRITE_S16MSB(p, v) \
+	{ (p)[0] = (Uint8)((v) >> 8); (p)[1] = (Uint8)(v); }
+
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+#define FUSED_SIZE_S16SYS	FUSED_SIZE_S16LSB
+#define FUSED_SIZE_S16OTH	FUSED_SIZE_S16MSB
+#define FUSED_READ_S16SYS(p)	FUSED_READ_S16LSB(p)
+#define FUSED_READ_S16OTH(p)	FUSED_READ_S16MSB(p)
+#define FUSED_WRITE_S16SYS(p, v) FUSED_WRITE_S16LSB(p, v)
+#else
+#define FUSED_SIZE_S16SYS	FUSED_SIZE_S16MSB
+#define FUSED_SIZE_S16OTH	FUSED_SIZE_S16LSB
+#define FUSED_READ_S16SYS(p)	FUSED_READ_S16MSB(p)
+#define FUSED_READ_S16OTH(p)	FUSED_READ_S16LSB(p)
+#define FUSED_WRITE_S16SYS(p, v) FUSED_WRITE_S16MSB(p, v)
+#endif
+#define FUSED_SIZE_F32SYS	4
+#define FUSED_READ_F32SYS(p)	SDL_FloatToS16(*(const float *)(p))
+
+#define FUSED_FORMAT_U8		AUDIO_U8
+#define FUSED_FORMAT_S8		AUDIO_S8
+#define FUSED_FORMAT_S16SYS	AUDIO_S16SYS
+#define FUSED_FORMAT_S16OTH	(AUDIO_S16SYS ^ 0x1000)
+#define FUSED_FORMAT_F32SYS	AUDIO_F32SYS
+
+/* Convert one input frame at s into 'rmul' output frames at d */
+#define FUSED_FRAME(src, dst, ich, och, rmul)				\
+{									\
+	Sint32 l, r;							\
+	int k;								\
+									\
+	l = FUSED_READ_##src(s);					\
+	r = (ich == 2) ? FUSED_READ_##src(s + FUSED_SIZE_##src) : l;	\
+	if ( och == 1 ) {						\
+		l = (l + r) / 2;					\
+	}								\
+	for ( k=0; k<rmul; ++k ) {					\
+		FUSED_WRITE_##dst(d + k*och*FUSED_SIZE_##dst, l);	\
+		if ( och == 2 ) {					\
+			FUSED_WRITE_##dst(d + (k*2+1)*FUSED_SIZE_##dst, r); \
+		}							\
+	}								\
+}
+
+/* Grow from the end of the buffer backwards, shrink from the front */
+#define FUSED_CVT(src, dst, ich, och, rmul)				\
+{									\
+	const int istep = FUSED_SIZE_##src * ich;			\
+	const int ostep = FUSED_SIZE_##dst * och * rmul;		\
+	int i, n;							\
+	Uint8 *s, *d;							\
+									\
+	n = cvt->len_cvt / istep;					\
+	if ( ostep > istep ) {						\
+		s = cvt->buf + n*istep;					\
+		d = cvt->buf + n*ostep;					\
+		for ( i=n; i; --i ) {					\
+			s -= istep;					\
+			d -= ostep;					\
+			FUSED_FRAME(src, dst, ich, och, rmul);		\
+		}							\
+	} else {							\
+		s = cvt->buf;						\
+		d = cvt->buf;						\
+		for ( i=n; i; --i ) {					\
+			FUSED_FRAME(src, dst, ich, och, rmul);		\
+			s += istep;					\
+			d += ostep;					\
+		}							\
+	}								\
+	cvt->len_cvt = n*ostep;						\
+	if ( cvt->filters[++cvt->filter_index] ) {			\
+		cvt->filters[cvt->filter_index](cvt, FUSED_FORMAT_##dst); \
+	}								\
+}
+
+#ifdef DEBUG_CONVERT
+#define FUSED_DEBUG(src, dst, ich, och, rmul) \
+	fprintf(stderr, "Converting " #src "/%d -> " #dst "/%d (rate x%d)\n", \
+	        ich, och, rmul);
+#else
+#define FUSED_DEBUG(src, dst, ich, och, rmul)
+#endif
+
+#define DEFINE_FUSED_CVT(src, dst, ich, och)				\
+static void SDLCALL SDL_Fused_##src##_##dst##_##ich##och(SDL_AudioCVT *cvt, Uint16 format) \
+{									\
+	FUSED_DEBUG(src, dst, ich, och, 1)				\
+	FUSED_CVT(src, dst, ich, och, 1)				\
+}									\
+static void SDLCALL SDL_Fused_##src##_##dst##_##ich##och##_x2(SDL_AudioCVT *cvt, Uint16 format) \
+{									\
+	FUSED_DEBUG(src, dst, ich, och, 2)				\
+	FUSED_CVT(src, dst, ich, och, 2)				\
+}
+
+#define FUSED_ENTRY(src, dst, ich, och)					\
+	{ FUSED_FORMAT_##src, ich, FUSED_FORMAT_##dst, och,		\
+	  SDL_Fused_##src##_##dst##_##ich##och,				\
+	  SDL_Fused_##src##_##dst##_##ich##och##_x2 }
+
+DEFINE_FUSED_CVT(U8, S16SYS, 1, 1)
+DEFINE_FUSED_CVT(U8, S16SYS, 1, 2)
+DEFINE_FUSED_CVT(U8, S16SYS, 2, 1)
+DEFINE_FUSED_CVT(U8, S16SYS, 2, 2)
+DEFINE_FUSED_CVT(S8, S16SYS, 1, 1)
+DEFINE_FUSED_CVT(S8, S16SYS, 1, 2)
+DEFINE_FUSED_CVT(S8, S16SYS, 2, 1)
+DEFINE_FUSED_CVT(S8, S16SYS, 2, 2)
+DEFINE_FUSED_CVT(S16SYS, S16SYS, 1, 2)
+DEFINE_FUSED_CVT(S16SYS, S16SYS, 2, 1)
+DEFINE_FUSED_CVT(S16OTH, S16SYS, 1, 1)
+DEFINE_FUSED_CVT(S16OTH, S16SYS, 1, 2)
+DEFINE_FUSED_CVT(S16OTH, S16SYS, 2, 1)
+DEFINE_FUSED_CVT(S16OTH, S16SYS, 2, 2)
+DEFINE_FUSED_CVT(S16SYS, U8, 1, 1)
+DEFINE_FUSED_CVT(S16SYS, U8, 1, 2)
+DEFINE_FUSED_CVT(S16SYS, U8, 2, 1)
+DEFINE_FUSED_CVT(S16SYS, U8, 2, 2)
+DEFINE_FUSED_CVT(F32SYS, S16SYS, 1, 1)
+DEFINE_FUSED_CVT(F32SYS, S16SYS, 1, 2)
+DEFINE_FUSED_CVT(F32SYS, S16SYS, 2, 1)
+DEFINE_FUSED_CVT(F32SYS, S16SYS, 2, 2)
+
+static const struct SDL_FusedCVT {
+	Uint16 src_format;
+	Uint8 src_channels;
+	Uint16 dst_format;
+	Uint8 dst_channels;
+	void (SDLCALL *cvt)(SDL_AudioCVT *cvt, Uint16 format);
+	void (SDLCALL *cvt_x2)(SDL_AudioCVT *cvt, Uint16 format);
+} SDL_fused_cvt[] = {
+	FUSED_ENTRY(U8, S16SYS, 1, 1),
+	FUSED_ENTRY(U8, S16SYS, 1, 2),
+	FUSED_ENTRY(U8, S16SYS, 2, 1),
+	FUSED_ENTRY(U8, S16SYS, 2, 2),
+	FUSED_ENTRY(S8, S16SYS, 1, 1),
+	FUSED_ENTRY(S8, S16SYS, 1, 2),
+	FUSED_ENTRY(S8, S16SYS, 2, 1),
+	FUSED_ENTRY(S8, S16SYS, 2, 2),
+	FUSED_ENTRY(S16SYS, S16SYS, 1, 2),
+	FUSED_ENTRY(S16SYS, S16SYS, 2, 1),
+	FUSED_ENTRY(S16OTH, S16SYS, 1, 1),
+	FUSED_ENTRY(S16OTH, S16SYS, 1, 2),
+	FUSED_ENTRY(S16OTH, S16SYS, 2, 1),
+	FUSED_ENTRY(S16OTH, S16SYS, 2, 2),
+	FUSED_ENTRY(S16SYS, U8, 1, 1),
+	FUSED_ENTRY(S16SYS, U8, 1, 2),
+	FUSED_ENTRY(S16SYS, U8, 2, 1),
+	FUSED_ENTRY(S16SYS, U8, 2, 2),
+	FUSED_ENTRY(F32SYS, S16SYS, 1, 1),
+	FUSED_ENTRY(F32SYS, S16SYS, 1, 2),
+	FUSED_ENTRY(F32SYS, S16SYS, 2, 1),
+	FUSED_ENTRY(F32SYS, S16SYS, 2, 2),
+};
+
+static const struct SDL_FusedCVT *SDL_FindFusedCVT(
+	Uint16 src_format, Uint8 src_channels,
+	Uint16 dst_format, Uint8 dst_channels)
+{
+	int i;
+
+	for ( i=0; i<(int)SDL_arraysize(SDL_fused_cvt); ++i ) {
+		const struct SDL_FusedCVT *fused = &SDL_fused_cvt[i];
+		if ( fused->src_format == src_format &&
+		     fused->src_channels == src_channels &&
+		     fused->dst_format == dst_format &&
+		     fused->dst_channels == dst_channels ) {
+			return(fused);
+		}
+	}
+	return(NULL);
+}
+
 int SDL_ConvertAudio(SDL_AudioCVT *cvt)
 {
 	/* Make sure there's data to convert */
@@ -1328,6 +1669,9 @@ int SDL_BuildAudioCVT(SDL_AudioCVT *cvt,
 	Uint16 src_format, Uint8 src_channels, int src_rate,
 	Uint16 dst_format, Uint8 dst_channels, int dst_rate)
 {
+	const struct SDL_FusedCVT *fused;
+	int to_float = 0;
+
 /*printf("Build format %04x->%04x, channels %u->%u, rate %d->%d\n",
 		src_format, dst_format, src_channels, dst_channels, src_rate, dst_rate);*/
 	/* Start off with no conversion necessary */
@@ -1336,20 +1680,54 @@ int SDL_BuildAudioCVT(SDL_AudioCVT *cvt,
 	cvt->filters[0] = NULL;
 	cvt->len_mult = 1;
 	cvt->len_ratio = 1.0;
+	cvt->src_format = src_format;
+	cvt->dst_format = dst_format;
+
+	/* Common format and channel changes are done in a single pass */
+	fused = SDL_FindFusedCVT(src_format, src_channels,
+	                         dst_format, dst_channels);
+
+	/* Otherwise float samples are converted to and from native 16-bit
+	   at the ends of the chain, and the filters in between only ever
+	   see integer samples */
+	if ( !fused && (src_format & 0x0100) ) {
+		cvt->filters[cvt->filter_index++] = SDL_ConvertFromFloat;
+		cvt->len_ratio /= 2;
+		src_format = AUDIO_S16SYS;
+	}
+	if ( !fused && (dst_format & 0x0100) ) {
+		to_float = 1;
+		dst_format = AUDIO_S16SYS;
+	}
+	if ( !fused ) {
+		fused = SDL_FindFusedCVT(src_format, src_channels,
+		                         dst_format, dst_channels);
+	}
+	if ( fused ) {
+		int src_size = (src_format & 0xFF) / 8 * src_channels;
+		int dst_size = (dst_format & 0xFF) / 8 * dst_channels;
+
+		cvt->filters[cvt->filter_index++] = fused->cvt;
+		if ( dst_size > src_size ) {
+			cvt->len_mult *= dst_size / src_size;
+		}
+		cvt->len_ratio *= (double)dst_size / src_size;
+		src_channels = dst_channels;
+	}
 
 	/* First filter:  Endian conversion from src to dst */
-	if ( (src_format & 0x1000) != (dst_format & 0x1000)
+	if ( !fused && (src_format & 0x1000) != (dst_format & 0x1000)
 	     && ((src_format & 0xff) == 16) && ((dst_format & 0xff) == 16)) {
 		cvt->filters[cvt->filter_index++] = SDL_ConvertEndian;
 	}
 	
 	/* Second filter: Sign conversion -- signed/unsigned */
-	if ( (src_format & 0x8000) != (dst_format & 0x8000) ) {
+	if ( !fused && (src_format & 0x8000) != (dst_format & 0x8000) ) {
 		cvt->filters[cvt->filter_index++] = SDL_ConvertSign;
 	}
 
 	/* Next filter:  Convert 16 bit <--> 8 bit PCM */
-	if ( (src_format & 0xFF) != (dst_format & 0xFF) ) {
+	if ( !fused && (src_format & 0xFF) != (dst_format & 0xFF) ) {
 		switch (dst_format&0x10FF) {
 			case AUDIO_U8:
 				cvt->filters[cvt->filter_index++] =
@@ -1468,40 +1846,46 @@ int SDL_BuildAudioCVT(SDL_AudioCVT *cvt,
 		}
 		/* If hi_rate = lo_rate*2^x then conversion is easy */
 		while ( ((lo_rate*2)/100) <= (hi_rate/100) ) {
-			cvt->filters[cvt->filter_index++] = rate_cvt;
+			if ( fused && (len_mult == 2) ) {
+				/* Fold the first doubling into the fused pass */
+				cvt->filters[cvt->filter_index-1] = fused->cvt_x2;
+				fused = NULL;
+			} else {
+				cvt->filters[cvt->filter_index++] = rate_cvt;
+			}
 			cvt->len_mult *= len_mult;
 			lo_rate *= 2;
 			cvt->len_ratio *= len_ratio;
 		}
 		/* We may need a slow conversion here to finish up */
 		if ( (lo_rate/100) != (hi_rate/100) ) {
-#if 1
-			/* The problem with this is that if the input buffer is
-			   say 1K, and the conversion rate is say 1.1, then the
-			   output buffer is 1.1K, which may not be an acceptable
-			   buffer size for the audio driver (not a power of 2)
-			*/
-			/* For now, punt and hope the rate distortion isn't great.
-			*/
-#else
+			switch (src_channels) {
+				case 1: rate_cvt = SDL_RateSLOW; break;
+				case 2: rate_cvt = SDL_RateSLOW_c2; break;
+				case 4: rate_cvt = SDL_RateSLOW_c4; break;
+				case 6: rate_cvt = SDL_RateSLOW_c6; break;
+				default: return -1;
+			}
 			if ( src_rate < dst_rate ) {
 				cvt->rate_incr = (double)lo_rate/hi_rate;
 				cvt->len_mult *= 2;
-				cvt->len_ratio /= cvt->rate_incr;
 			} else {
 				cvt->rate_incr = (double)hi_rate/lo_rate;
-				cvt->len_ratio *= cvt->rate_incr;
 			}
-			cvt->filters[cvt->filter_index++] = SDL_RateSLOW;
-#endif
+			cvt->len_ratio /= cvt->rate_incr;
+			cvt->filters[cvt->filter_index++] = rate_cvt;
 		}
 	}
 
+	if ( to_float ) {
+		cvt->filters[cvt->filter_index++] = SDL_ConvertToFloat;
+		cvt->len_mult *= 2;
+		cvt->len_ratio *= 2;
+	}
+
 	/* Set up the filter information */
 	if ( cvt->filter_index != 0 ) {
 		cvt->needed = 1;
-		cvt->src_format = src_format;
-		cvt->dst_format = dst_format;
 		cvt->len = 0;
 		cvt->buf = NULL;
 		cvt->filters[cvt->filter_index] = NULL;
@@ -31,6 +31,14 @@
 #include "SDL_mixer_MMX_VC.h"
 #include "SDL_mixer_m68k.h"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define SDL_MIX_SSE2	1
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define SDL_MIX_NEON	1
+#endif
+
 /* This table is used to add two sound values together and pin
  * the value to avoid overflow.  (used with permission from ARDI)
  * Changed to use 0xFE instead of 0xFF for better sound quality.
@@ -90,6 +98,90 @@ static const Uint8 mix8[] =
 #define ADJUST_VOLUME(s, v)	(s = (s*v)/SDL_MIX_MAXVOLUME)
 #define ADJUST_VOLUME_U8(s, v)	(s = (((s-128)*v)/SDL_MIX_MAXVOLUME)+128)
 
+#if SDL_MIX_SSE2 || SDL_MIX_NEON
+/* Mix native 16-bit samples eight at a time with saturating adds.
+   The volume is scaled with the same truncating divide as the scalar
+   loop, so both give identical results.  Returns the samples mixed.
+*/
+static Uint32 SDL_MixAudio_S16SYS_SIMD(Sint16 *dst, const Sint16 *src, Uint32 len, int volume)
+{
+	Uint32 i, n = len & ~7;
+
+#if SDL_MIX_SSE2
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i vol = _mm_set1_epi32(volume);
+	const __m128i round = _mm_set1_epi32(SDL_MIX_MAXVOLUME-1);
+
+	if ( volume == SDL_MIX_MAXVOLUME ) {
+		for ( i=0; i<n; i+=8 ) {
+			__m128i s = _mm_loadu_si128((const __m128i *)(src+i));
+			__m128i d = _mm_loadu_si128((const __m128i *)(dst+i));
+			_mm_storeu_si128((__m128i *)(dst+i), _mm_adds_epi16(d, s));
+		}
+		return(n);
+	}
+	for ( i=0; i<n; i+=8 ) {
+		__m128i s = _mm_loadu_si128((const __m128i *)(src+i));
+		__m128i d = _mm_loadu_si128((const __m128i *)(dst+i));
+		__m128i lo = _mm_madd_epi16(_mm_unpacklo_epi16(s, zero), vol);
+		__m128i hi = _mm_madd_epi16(_mm_unpackhi_epi16(s, zero), vol);
+		lo = _mm_add_epi32(lo, _mm_and_si128(_mm_srai_epi32(lo, 31), round));
+		hi = _mm_add_epi32(hi, _mm_and_si128(_mm_srai_epi32(hi, 31), round));
+		s = _mm_packs_epi32(_mm_srai_epi32(lo, 7), _mm_srai_epi32(hi, 7));
+		_mm_storeu_si128((__m128i *)(dst+i), _mm_adds_epi16(d, s));
+	}
+#else
+	const int32x4_t round = vdupq_n_s32(SDL_MIX_MAXVOLUME-1);
+	const int16x4_t vol = vdup_n_s16((Sint16)volume);
+
+	if ( volume == SDL_MIX_MAXVOLUME ) {
+		for ( i=0; i<n; i+=8 ) {
+			vst1q_s16(dst+i, vqaddq_s16(vld1q_s16(dst+i), vld1q_s16(src+i)));
+		}
+		return(n);
+	}
+	for ( i=0; i<n; i+=8 ) {
+		int16x8_t s = vld1q_s16(src+i);
+		int32x4_t lo = vmull_s16(vget_low_s16(s), vol);
+		int32x4_t hi = vmull_s16(vget_high_s16(s), vol);
+		lo = vaddq_s32(lo, vandq_s32(vshrq_n_s32(lo, 31), round));
+		hi = vaddq_s32(hi, vandq_s32(vshrq_n_s32(hi, 31), round));
+		s = vcombine_s16(vqmovn_s32(vshrq_n_s32(lo, 7)),
+		                 vqmovn_s32(vshrq_n_s32(hi, 7)));
+		vst1q_s16(dst+i, vqaddq_s16(vld1q_s16(dst+i), s));
+	}
+#endif
+	return(n);
+}
+
+/* Mix native float samples four at a time, clipping to -1.0 .. 1.0 */
+static Uint32 SDL_MixAudio_F32SYS_SIMD(float *dst, const float *src, Uint32 len, float volume)
+{
+	Uint32 i, n = len & ~3;
+
+#if SDL_MIX_SSE2
+	const __m128 vol = _mm_set1_ps(volume);
+	const __m128 max = _mm_set1_ps(1.0f);
+	const __m128 min = _mm_set1_ps(-1.0f);
+
+	for ( i=0; i<n; i+=4 ) {
+		__m128 d = _mm_add_ps(_mm_loadu_ps(dst+i),
+		                      _mm_mul_ps(_mm_loadu_ps(src+i), vol));
+		_mm_storeu_ps(dst+i, _mm_max_ps(_mm_min_ps(d, max), min));
+	}
+#else
+	const float32x4_t max = vdupq_n_f32(1.0f);
+	const float32x4_t min = vdupq_n_f32(-1.0f);
+
+	for ( i=0; i<n; i+=4 ) {
+		float32x4_t d = vmlaq_n_f32(vld1q_f32(dst+i), vld1q_f32(src+i), volume);
+		vst1q_f32(dst+i, vmaxq_f32(vminq_f32(d, max), min));
+	}
+#endif
+	return(n);
+}
+#endif /* SDL_MIX_SSE2 || SDL_MIX_NEON */
+
 void SDL_MixAudio (Uint8 *dst, const Uint8 *src, Uint32 len, int volume)
 {
 	Uint16 format;
@@ -108,6 +200,24 @@ void SDL_MixAudio (Uint8 *dst, const Uint8 *src, Uint32 len, int volume)
   		/* HACK HACK HACK */
 		format = AUDIO_S16;
 	}
+#if SDL_MIX_SSE2 || SDL_MIX_NEON
+	/* The native formats go through the vector unit, and the scalar
+	   loops below only finish off the last few samples */
+	if ( format == AUDIO_S16SYS ) {
+		Uint32 done = SDL_MixAudio_S16SYS_SIMD((Sint16 *)dst,
+		                    (const Sint16 *)src, len/2, volume);
+		dst += done*2;
+		src += done*2;
+		len -= done*2;
+	} else if ( format == AUDIO_F32SYS ) {
+		Uint32 done = SDL_MixAudio_F32SYS_SIMD((float *)dst,
+		                    (const float *)src, len/4,
+		                    (float)volume / SDL_MIX_MAXVOLUME);
+		dst += done*4;
+		src += done*4;
+		len -= done*4;
+	}
+#endif
 	switch (format) {
 
 		case AUDIO_U8: {
@@ -256,9 +366,539 @@ void SDL_MixAudio (Uint8 *dst, const Uint8 *src, Uint32 len, int volume)
 		}
 		break;
 
+		case AUDIO_F32LSB:
+		case AUDIO_F32MSB: {
+			const float fvolume = (float)volume / SDL_MIX_MAXVOLUME;
+			union { Uint32 u; float f; } src_sample, dst_sample;
+			float sample;
+
+			len /= 4;
+			while ( len-- ) {
+				src_sample.u = *(const Uint32 *)src;
+				dst_sample.u = *(Uint32 *)dst;
+				if ( format == AUDIO_F32MSB ) {
+					src_sample.u = SDL_SwapBE32(src_sample.u);
+					dst_sample.u = SDL_SwapBE32(dst_sample.u);
+				} else {
+					src_sample.u = SDL_SwapLE32(src_sample.u);
+					dst_sample.u = SDL_SwapLE32(dst_sample.u);
+				}
+				sample = dst_sample.f + src_sample.f * fvolume;
+				if ( sample > 1.0f ) {
+					sample = 1.0f;
+				} else
+				if ( sample < -1.0f ) {
+					sample = -1.0f;
+				}
+				dst_sample.f = sample;
+				if ( format == AUDIO_F32MSB ) {
+					*(Uint32 *)dst = SDL_SwapBE32(dst_sample.u);
+				} else {
+					*(Uint32 *)dst = SDL_SwapLE32(dst_sample.u);
+				}
+				src += 4;
+				dst += 4;
+			}
+		}
+		break;
+
 		default: /* If this happens... FIXME! */
 			SDL_SetError("SDL_MixAudio(): unknown audio format");
 			return;
 	}
 }
 
+
+/* The built-in voice mixer.
+   Every active voice is mixed into each period in a single pass, a
+   block of frames at a time.  All the voices are summed while the block
+   is in the cache, then the sum is added to the stream and stored back
+   once.  Blocks no voice played into are left untouched.
+*/
+#define VOICE_BLOCK_FRAMES	128
+#define VOICE_MAX_CHANNELS	6
+
+struct SDL_AudioVoice {
+	int id;			/* 0 when the slot is free */
+	const Uint8 *data;	/* The samples of a memory voice */
+	Uint8 *buf;		/* Converted samples owned by the voice */
+	Uint32 len;
+	Uint32 pos;
+	SDL_RWops *src;		/* Or the source of a streaming voice */
+	int freesrc;
+	int start;		/* Where the stream loops back to */
+	int loops;		/* Repeats left, -1 to loop forever */
+	float gain[VOICE_MAX_CHANNELS];
+};
+
+/* Widen samples of the mixing format to float */
+static void SDL_VoiceToFloat(float *dst, const Uint8 *src, int samples, Uint16 format)
+{
+	union { Uint32 u; float f; } sample;
+	Uint16 value;
+	int i;
+
+	switch (format) {
+	    case AUDIO_U8:
+		for ( i=0; i<samples; ++i ) {
+			dst[i] = (float)((int)src[i] - 128) * (1.0f / 128.0f);
+		}
+		break;
+	    case AUDIO_S8:
+		for ( i=0; i<samples; ++i ) {
+			dst[i] = (float)(Sint8)src[i] * (1.0f / 128.0f);
+		}
+		break;
+	    case AUDIO_U16LSB:
+	    case AUDIO_S16LSB:
+	    case AUDIO_U16MSB:
+	    case AUDIO_S16MSB:
+		for ( i=0; i<samples; ++i, src += 2 ) {
+			if ( format & 0x1000 ) {
+				value = (Uint16)((src[0] << 8) | src[1]);
+			} else {
+				value = (Uint16)((src[1] << 8) | src[0]);
+			}
+			if ( !(format & 0x8000) ) {
+				value ^= 0x8000;
+			}
+			dst[i] = (float)(Sint16)value * (1.0f / 32768.0f);
+		}
+		break;
+	    case AUDIO_F32LSB:
+	    case AUDIO_F32MSB:
+		for ( i=0; i<samples; ++i, src += 4 ) {
+			sample.u = *(const Uint32 *)src;
+			if ( format == AUDIO_F32MSB ) {
+				sample.u = SDL_SwapBE32(sample.u);
+			} else {
+				sample.u = SDL_SwapLE32(sample.u);
+			}
+			dst[i] = sample.f;
+		}
+		break;
+	}
+}
+
+/* Store the mixed samples in the mixing format, clipping integer ones */
+static void SDL_FloatToVoice(Uint8 *dst, const float *src, int samples, Uint16 format)
+{
+	union { Uint32 u; float f; } sample;
+	Sint32 value;
+	int i;
+
+	switch (format) {
+	    case AUDIO_U8:
+	    case AUDIO_S8:
+		for ( i=0; i<samples; ++i ) {
+			value = (Sint32)(src[i] * 128.0f);
+			if ( value > 127 ) {
+				value = 127;
+			} else if ( value < -128 ) {
+				value = -128;
+			}
+			dst[i] = (Uint8)((format == AUDIO_U8) ? value+128 : value);
+		}
+		break;
+	    case AUDIO_U16LSB:
+	    case AUDIO_S16LSB:
+	    case AUDIO_U16MSB:
+	    case AUDIO_S16MSB:
+		for ( i=0; i<samples; ++i, dst += 2 ) {
+			value = (Sint32)(src[i] * 32768.0f);
+			if ( value > 32767 ) {
+				value = 32767;
+			} else if ( value < -32768 ) {
+				value = -32768;
+			}
+			if ( !(format & 0x8000) ) {
+				value ^= 0x8000;
+			}
+			if ( format & 0x1000 ) {
+				dst[0] = (Uint8)(value >> 8);
+				dst[1] = (Uint8)value;
+			} else {
+				dst[0] = (Uint8)value;
+				dst[1] = (Uint8)(value >> 8);
+			}
+		}
+		break;
+	    case AUDIO_F32LSB:
+	    case AUDIO_F32MSB:
+		for ( i=0; i<samples; ++i, dst += 4 ) {
+			sample.f = src[i];
+			if ( format == AUDIO_F32MSB ) {
+				*(Uint32 *)dst = SDL_SwapBE32(sample.u);
+			} else {
+				*(Uint32 *)dst = SDL_SwapLE32(sample.u);
+			}
+		}
+		break;
+	}
+}
+
+/* Get up to 'frames' frames of a voice, looping back to the start as
+   often as asked.  Returns fewer frames only when the voice has ended.
+*/
+static int SDL_GetVoiceFrames(struct SDL_AudioVoice *voice, int frame,
+                              Uint8 *scratch, int frames, const Uint8 **data)
+{
+	int got;
+	int rewound = 0;
+
+	for ( ;; ) {
+		if ( voice->src ) {
+			got = SDL_RWread(voice->src, scratch, frame, frames);
+			*data = scratch;
+		} else {
+			got = (voice->len - voice->pos) / frame;
+			if ( got > frames ) {
+				got = frames;
+			}
+			*data = voice->data + voice->pos;
+			voice->pos += got * frame;
+		}
+		if ( (got > 0) || (voice->loops == 0) || rewound ) {
+			return((got > 0) ? got : 0);
+		}
+		if ( voice->loops > 0 ) {
+			--voice->loops;
+		}
+		if ( voice->src ) {
+			if ( SDL_RWseek(voice->src, voice->start, RW_SEEK_SET) < 0 ) {
+				return(0);
+			}
+		} else {
+			voice->pos = 0;
+		}
+		rewound = 1;
+	}
+}
+
+static void SDL_ReleaseVoice(SDL_AudioDevice *audio,
+                             struct SDL_AudioVoice *voice)
+{
+	if ( voice->src && voice->freesrc ) {
+		SDL_RWclose(voice->src);
+	}
+	if ( voice->buf ) {
+		SDL_free(voice->buf);
+	}
+	SDL_memset(voice, 0, sizeof(*voice));
+	--audio->playing_voices;
+}
+
+/* Called by the audio thread with the mixer lock held */
+void SDL_MixVoices(SDL_AudioDevice *audio, Uint8 *stream, int len)
+{
+	float mix[VOICE_BLOCK_FRAMES*VOICE_MAX_CHANNELS];
+	float samples[VOICE_BLOCK_FRAMES*VOICE_MAX_CHANNELS];
+	Uint8 scratch[VOICE_BLOCK_FRAMES*VOICE_MAX_CHANNELS*4];
+	const Uint8 *data;
+	struct SDL_AudioVoice *voice;
+	int channels, frame, frames, block, done, got, mixed;
+	int i, v, f, c;
+
+	if ( ! audio->playing_voices ) {
+		return;
+	}
+
+	channels = audio->voice_channels;
+	frame = ((audio->voice_format & 0xFF) / 8) * channels;
+	frames = len / frame;
+	for ( ; frames > 0; frames -= block, stream += block*frame ) {
+		block = SDL_min(frames, VOICE_BLOCK_FRAMES);
+		SDL_memset(mix, 0, block*channels*sizeof(float));
+
+		mixed = 0;
+		for ( v=0; v<audio->num_voices; ++v ) {
+			voice = &audio->voices[v];
+			if ( ! voice->id ) {
+				continue;
+			}
+			for ( done=0; done<block; done+=got ) {
+				got = SDL_GetVoiceFrames(voice, frame, scratch,
+				                         block-done, &data);
+				if ( got == 0 ) {
+					SDL_ReleaseVoice(audio, voice);
+					break;
+				}
+				mixed = 1;
+				SDL_VoiceToFloat(samples, data, got*channels,
+				                 audio->voice_format);
+				i = done*channels;
+				for ( f=0; f<got; ++f ) {
+					for ( c=0; c<channels; ++c, ++i ) {
+						mix[i] += samples[i-done*channels] * voice->gain[c];
+					}
+				}
+			}
+		}
+
+		if ( ! mixed ) {
+			continue;
+		}
+
+		/* Float streams keep the callback's own samples as they are,
+		   only the voices are clipped */
+		if ( audio->voice_format & 0x0100 ) {
+			for ( i=0; i<block*channels; ++i ) {
+				mix[i] = SDL_max(-1.0f, SDL_min(mix[i], 1.0f));
+			}
+		}
+		SDL_VoiceToFloat(samples, stream, block*channels,
+		                 audio->voice_format);
+		for ( i=0; i<block*channels; ++i ) {
+			samples[i] += mix[i];
+		}
+		SDL_FloatToVoice(stream, samples, block*channels,
+		                 audio->voice_format);
+	}
+}
+
+void SDL_FreeVoices(SDL_AudioDevice *audio)
+{
+	int v;
+
+	for ( v=0; v<audio->num_voices; ++v ) {
+		if ( audio->voices[v].id ) {
+			SDL_ReleaseVoice(audio, &audio->voices[v]);
+		}
+	}
+	if ( audio->voices ) {
+		SDL_free(audio->voices);
+		audio->voices = NULL;
+	}
+	audio->num_voices = 0;
+}
+
+/* Find a voice by id, the audio must be locked */
+static struct SDL_AudioVoice *SDL_FindVoice(int id)
+{
+	SDL_AudioDevice *audio = current_audio;
+	int v;
+
+	if ( audio && (id > 0) ) {
+		for ( v=0; v<audio->num_voices; ++v ) {
+			if ( audio->voices[v].id == id ) {
+				return(&audio->voices[v]);
+			}
+		}
+	}
+	return(NULL);
+}
+
+static void SDL_SetVoiceGains(struct SDL_AudioVoice *voice, int channels,
+                              int volume, int pan)
+{
+	float gain, left, right;
+	int c;
+
+	volume = SDL_max(0, SDL_min(volume, SDL_MIX_MAXVOLUME));
+	pan = SDL_max(-128, SDL_min(pan, 128));
+	gain = (float)volume / SDL_MIX_MAXVOLUME;
+	left = (pan > 0) ? gain * (128 - pan) / 128.0f : gain;
+	right = (pan < 0) ? gain * (128 + pan) / 128.0f : gain;
+
+	/* Even channels are on the left, except for the center and
+	   subwoofer channels of 5.1 audio */
+	for ( c=0; c<channels; ++c ) {
+		if ( (channels == 1) || ((channels == 6) && (c == 2 || c == 3)) ) {
+			voice->gain[c] = gain;
+		} else {
+			voice->gain[c] = (c & 1) ? right : left;
+		}
+	}
+}
+
+/* Claim a voice slot and give it an id, the audio must be locked */
+static struct SDL_AudioVoice *SDL_NewVoice(void)
+{
+	SDL_AudioDevice *audio = current_audio;
+	struct SDL_AudioVoice *voices;
+	int v;
+
+	for ( v=0; v<audio->num_voices; ++v ) {
+		if ( ! audio->voices[v].id ) {
+			break;
+		}
+	}
+	if ( v == audio->num_voices ) {
+		voices = (struct SDL_AudioVoice *)SDL_realloc(audio->voices,
+		                (audio->num_voices+8)*sizeof(*voices));
+		if ( voices == NULL ) {
+			SDL_OutOfMemory();
+			return(NULL);
+		}
+		SDL_memset(voices+audio->num_voices, 0, 8*sizeof(*voices));
+		audio->voices = voices;
+		audio->num_voices += 8;
+	}
+	if ( ++audio->voice_serial <= 0 ) {
+		audio->voice_serial = 1;
+	}
+	audio->voices[v].id = audio->voice_serial;
+	++audio->playing_voices;
+	SDL_SetVoiceGains(&audio->voices[v], audio->voice_channels,
+	                  SDL_MIX_MAXVOLUME, 0);
+	return(&audio->voices[v]);
+}
+
+/* Returns 1 if voice data in 'spec' can be mixed as it is */
+static int SDL_VoiceSpecMatches(const SDL_AudioSpec *spec)
+{
+	SDL_AudioDevice *audio = current_audio;
+
+	return( (spec == NULL) ||
+	        ((spec->format == audio->voice_format) &&
+	         (spec->channels == audio->voice_channels) &&
+	         (spec->freq == audio->voice_freq)) );
+}
+
+int SDL_PlayVoice(const Uint8 *data, Uint32 len, const SDL_AudioSpec *spec, int loops)
+{
+	SDL_AudioDevice *audio = current_audio;
+	struct SDL_AudioVoice *voice;
+	SDL_AudioCVT cvt;
+	int frame, id;
+
+	if ( ! audio || ! audio->opened ) {
+		SDL_SetError("Audio device isn't open");
+		return(-1);
+	}
+	if ( spec ) {
+		frame = ((spec->format & 0xFF) / 8) * spec->channels;
+	} else {
+		frame = ((audio->voice_format & 0xFF) / 8) * audio->voice_channels;
+	}
+	if ( (data == NULL) || (frame == 0) || (len < (Uint32)frame) ) {
+		SDL_SetError("SDL_PlayVoice() passed no audio data");
+		return(-1);
+	}
+	len -= (len % frame);
+
+	/* Convert the data to the mixing format before the voice starts */
+	cvt.buf = NULL;
+	if ( ! SDL_VoiceSpecMatches(spec) ) {
+		if ( SDL_BuildAudioCVT(&cvt, spec->format, spec->channels,
+		                       spec->freq, audio->voice_format,
+		                       audio->voice_channels,
+		                       audio->voice_freq) < 0 ) {
+			return(-1);
+		}
+		cvt.len = (int)len;
+		cvt.buf = (Uint8 *)SDL_malloc(cvt.len*cvt.len_mult);
+		if ( cvt.buf == NULL ) {
+			SDL_OutOfMemory();
+			return(-1);
+		}
+		SDL_memcpy(cvt.buf, data, len);
+		if ( SDL_ConvertAudio(&cvt) < 0 ) {
+			SDL_free(cvt.buf);
+			return(-1);
+		}
+		data = cvt.buf;
+		frame = ((audio->voice_format & 0xFF) / 8) *
+		        audio->voice_channels;
+		len = cvt.len_cvt - (cvt.len_cvt % frame);
+		if ( len == 0 ) {
+			SDL_free(cvt.buf);
+			SDL_SetError("SDL_PlayVoice() passed no audio data");
+			return(-1);
+		}
+	}
+
+	SDL_LockAudio();
+	voice = SDL_NewVoice();
+	if ( voice ) {
+		voice->data = data;
+		voice->buf = cvt.buf;
+		voice->len = len;
+		voice->loops = loops;
+		id = voice->id;
+	} else {
+		id = -1;
+	}
+	SDL_UnlockAudio();
+	if ( (id < 0) && cvt.buf ) {
+		SDL_free(cvt.buf);
+	}
+	return(id);
+}
+
+int SDL_PlayVoiceRW(SDL_RWops *src, int freesrc, const SDL_AudioSpec *spec, int loops)
+{
+	SDL_AudioDevice *audio = current_audio;
+	struct SDL_AudioVoice *voice;
+	int id;
+
+	if ( src == NULL ) {
+		SDL_SetError("SDL_PlayVoiceRW() passed a NULL data source");
+		return(-1);
+	}
+	if ( ! audio || ! audio->opened ) {
+		SDL_SetError("Audio device isn't open");
+		id = -1;
+	} else if ( ! SDL_VoiceSpecMatches(spec) ) {
+		SDL_SetError("Streamed voices must be in the mixing format");
+		id = -1;
+	} else {
+		SDL_LockAudio();
+		voice = SDL_NewVoice();
+		if ( voice ) {
+			voice->src = src;
+			voice->freesrc = freesrc;
+			voice->start = SDL_RWtell(src);
+			voice->loops = loops;
+			id = voice->id;
+		} else {
+			id = -1;
+		}
+		SDL_UnlockAudio();
+	}
+	if ( (id < 0) && freesrc ) {
+		SDL_RWclose(src);
+	}
+	return(id);
+}
+
+int SDL_SetVoiceGain(int id, int volume, int pan)
+{
+	struct SDL_AudioVoice *voice;
+	int retval;
+
+	SDL_LockAudio();
+	voice = SDL_FindVoice(id);
+	if ( voice ) {
+		SDL_SetVoiceGains(voice, current_audio->voice_channels,
+		                  volume, pan);
+		retval = 0;
+	} else {
+		SDL_SetError("No such voice");
+		retval = -1;
+	}
+	SDL_UnlockAudio();
+	return(retval);
+}
+
+int SDL_VoicePlaying(int id)
+{
+	int playing;
+
+	SDL_LockAudio();
+	playing = (SDL_FindVoice(id) != NULL);
+	SDL_UnlockAudio();
+	return(playing);
+}
+
+void SDL_StopVoice(int id)
+{
+	struct SDL_AudioVoice *voice;
+
+	SDL_LockAudio();
+	voice = SDL_FindVoice(id);
+	if ( voice ) {
+		SDL_ReleaseVoice(current_audio, voice);
+	}
+	SDL_UnlockAudio();
+}
@@ -70,6 +70,10 @@ struct SDL_AudioDevice {
 	/* An audio conversion block for audio format emulation */
 	SDL_AudioCVT convert;
 
+	/* The resampler's last input frame, carried over between callbacks */
+	int rate_carry;
+	Sint32 rate_last[6];
+
 	/* Current state flags */
 	int enabled;
 	int paused;
@@ -81,6 +85,24 @@ struct SDL_AudioDevice {
 	/* A semaphore for locking the mixing buffers */
 	SDL_mutex *mixer_lock;
 
+	/* The ring buffer of push mode, written by SDL_PushAudio() */
+	Uint8 *push_buf;
+	Uint32 push_size;	/* A power of two */
+	Uint32 push_frame;	/* Bytes per sample frame */
+	Uint8 push_silence;
+	Uint32 push_head;	/* Only written by the pushing thread */
+	Uint32 push_tail;	/* Only written by the audio thread */
+	Uint32 push_underruns;
+
+	/* The voices of the built-in mixer, see SDL_mixer.c */
+	struct SDL_AudioVoice *voices;
+	int num_voices;		/* Slots allocated, free ones have id 0 */
+	int playing_voices;	/* Slots in use, the mix is skipped at 0 */
+	int voice_serial;	/* The id of the last voice started */
+	Uint16 voice_format;	/* The stream the voices are mixed into */
+	Uint8 voice_channels;
+	int voice_freq;
+
 	/* A thread to feed the audio device */
 	SDL_Thread *thread;
 	Uint32 threadid;
@@ -95,6 +117,10 @@ struct SDL_AudioDevice {
 };
 #undef _THIS
 
+/* The built-in voice mixer, in SDL_mixer.c */
+extern void SDL_MixVoices(SDL_AudioDevice *audio, Uint8 *stream, int len);
+extern void SDL_FreeVoices(SDL_AudioDevice *audio);
+
 typedef struct AudioBootStrap {
 	const char *name;
 	const char *desc;
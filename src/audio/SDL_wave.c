@@ -35,46 +35,56 @@ struct MS_ADPCM_decodestate {
 	Sint16 iSamp1;
 	Sint16 iSamp2;
 };
-static struct MS_ADPCM_decoder {
+struct MS_ADPCM_decoder {
 	WaveFMT wavefmt;
 	Uint16 wSamplesPerBlock;
 	Uint16 wNumCoef;
 	Sint16 aCoeff[7][2];
 	/* * * */
 	struct MS_ADPCM_decodestate state[2];
-} MS_ADPCM_state;
+};
 
-static int InitMS_ADPCM(WaveFMT *format)
+static int InitMS_ADPCM(struct MS_ADPCM_decoder *decoder, WaveFMT *format)
 {
 	Uint8 *rogue_feel;
 	int i;
 
 	/* Set the rogue pointer to the MS_ADPCM specific data */
-	MS_ADPCM_state.wavefmt.encoding = SDL_SwapLE16(format->encoding);
-	MS_ADPCM_state.wavefmt.channels = SDL_SwapLE16(format->channels);
-	MS_ADPCM_state.wavefmt.frequency = SDL_SwapLE32(format->frequency);
-	MS_ADPCM_state.wavefmt.byterate = SDL_SwapLE32(format->byterate);
-	MS_ADPCM_state.wavefmt.blockalign = SDL_SwapLE16(format->blockalign);
-	MS_ADPCM_state.wavefmt.bitspersample =
+	decoder->wavefmt.encoding = SDL_SwapLE16(format->encoding);
+	decoder->wavefmt.channels = SDL_SwapLE16(format->channels);
+	decoder->wavefmt.frequency = SDL_SwapLE32(format->frequency);
+	decoder->wavefmt.byterate = SDL_SwapLE32(format->byterate);
+	decoder->wavefmt.blockalign = SDL_SwapLE16(format->blockalign);
+	decoder->wavefmt.bitspersample =
 					 SDL_SwapLE16(format->bitspersample);
 	rogue_feel = (Uint8 *)format+sizeof(*format);
 	if ( sizeof(*format) == 16 ) {
 		rogue_feel += sizeof(Uint16);
 	}
-	MS_ADPCM_state.wSamplesPerBlock = ((rogue_feel[1]<<8)|rogue_feel[0]);
+	decoder->wSamplesPerBlock = ((rogue_feel[1]<<8)|rogue_feel[0]);
 	rogue_feel += sizeof(Uint16);
-	MS_ADPCM_state.wNumCoef = ((rogue_feel[1]<<8)|rogue_feel[0]);
+	decoder->wNumCoef = ((rogue_feel[1]<<8)|rogue_feel[0]);
 	rogue_feel += sizeof(Uint16);
-	if ( MS_ADPCM_state.wNumCoef != 7 ) {
+	if ( decoder->wNumCoef != 7 ) {
 		SDL_SetError("Unknown set of MS_ADPCM coefficients");
 		return(-1);
 	}
-	for ( i=0; i<MS_ADPCM_state.wNumCoef; ++i ) {
-		MS_ADPCM_state.aCoeff[i][0] = ((rogue_feel[1]<<8)|rogue_feel[0]);
+	for ( i=0; i<decoder->wNumCoef; ++i ) {
+		decoder->aCoeff[i][0] = ((rogue_feel[1]<<8)|rogue_feel[0]);
 		rogue_feel += sizeof(Uint16);
-		MS_ADPCM_state.aCoeff[i][1] = ((rogue_feel[1]<<8)|rogue_feel[0]);
+		decoder->aCoeff[i][1] = ((rogue_feel[1]<<8)|rogue_feel[0]);
 		rogue_feel += sizeof(Uint16);
 	}
+	/* Each block must hold its header and all of its samples */
+	if ( (decoder->wavefmt.channels < 1) ||
+	     (decoder->wavefmt.channels > 2) ||
+	     (decoder->wSamplesPerBlock < 2) ||
+	     (((decoder->wSamplesPerBlock-2)*decoder->wavefmt.channels) % 2) ||
+	     (decoder->wavefmt.blockalign < 7*decoder->wavefmt.channels +
+	      (decoder->wSamplesPerBlock-2)*decoder->wavefmt.channels/2) ) {
+		SDL_SetError("Invalid MS_ADPCM block size");
+		return(-1);
+	}
 	return(0);
 }
 
@@ -112,22 +122,102 @@ static Sint32 MS_ADPCM_nibble(struct MS_ADPCM_decodestate *state,
 	return(new_sample);
 }
 
-static int MS_ADPCM_decode(Uint8 **audio_buf, Uint32 *audio_len)
+/* Decode one block of encoded data into wSamplesPerBlock sample frames */
+static void MS_ADPCM_decode_block(struct MS_ADPCM_decoder *decoder,
+				const Uint8 *encoded, Uint8 *decoded)
 {
 	struct MS_ADPCM_decodestate *state[2];
-	Uint8 *freeable, *encoded, *decoded;
-	Sint32 encoded_len, samplesleft;
+	Sint32 samplesleft;
 	Sint8 nybble, stereo;
 	Sint16 *coeff[2];
 	Sint32 new_sample;
 
+	stereo = (decoder->wavefmt.channels == 2);
+	state[0] = &decoder->state[0];
+	state[1] = &decoder->state[stereo];
+
+	/* Grab the initial information for this block */
+	state[0]->hPredictor = *encoded++;
+	if ( stereo ) {
+		state[1]->hPredictor = *encoded++;
+	}
+	state[0]->iDelta = ((encoded[1]<<8)|encoded[0]);
+	encoded += sizeof(Sint16);
+	if ( stereo ) {
+		state[1]->iDelta = ((encoded[1]<<8)|encoded[0]);
+		encoded += sizeof(Sint16);
+	}
+	state[0]->iSamp1 = ((encoded[1]<<8)|encoded[0]);
+	encoded += sizeof(Sint16);
+	if ( stereo ) {
+		state[1]->iSamp1 = ((encoded[1]<<8)|encoded[0]);
+		encoded += sizeof(Sint16);
+	}
+	state[0]->iSamp2 = ((encoded[1]<<8)|encoded[0]);
+	encoded += sizeof(Sint16);
+	if ( stereo ) {
+		state[1]->iSamp2 = ((encoded[1]<<8)|encoded[0]);
+		encoded += sizeof(Sint16);
+	}
+	coeff[0] = decoder->aCoeff[state[0]->hPredictor % 7];
+	coeff[1] = decoder->aCoeff[state[1]->hPredictor % 7];
+
+	/* Store the two initial samples we start with */
+	decoded[0] = state[0]->iSamp2&0xFF;
+	decoded[1] = state[0]->iSamp2>>8;
+	decoded += 2;
+	if ( stereo ) {
+		decoded[0] = state[1]->iSamp2&0xFF;
+		decoded[1] = state[1]->iSamp2>>8;
+		decoded += 2;
+	}
+	decoded[0] = state[0]->iSamp1&0xFF;
+	decoded[1] = state[0]->iSamp1>>8;
+	decoded += 2;
+	if ( stereo ) {
+		decoded[0] = state[1]->iSamp1&0xFF;
+		decoded[1] = state[1]->iSamp1>>8;
+		decoded += 2;
+	}
+
+	/* Decode and store the other samples in this block */
+	samplesleft = (decoder->wSamplesPerBlock-2)*
+				decoder->wavefmt.channels;
+	while ( samplesleft > 0 ) {
+		nybble = (*encoded)>>4;
+		new_sample = MS_ADPCM_nibble(state[0],nybble,coeff[0]);
+		decoded[0] = new_sample&0xFF;
+		new_sample >>= 8;
+		decoded[1] = new_sample&0xFF;
+		decoded += 2;
+
+		nybble = (*encoded)&0x0F;
+		new_sample = MS_ADPCM_nibble(state[1],nybble,coeff[1]);
+		decoded[0] = new_sample&0xFF;
+		new_sample >>= 8;
+		decoded[1] = new_sample&0xFF;
+		decoded += 2;
+
+		++encoded;
+		samplesleft -= 2;
+	}
+}
+
+static int MS_ADPCM_decode(struct MS_ADPCM_decoder *decoder,
+				Uint8 **audio_buf, Uint32 *audio_len)
+{
+	Uint8 *freeable, *encoded, *decoded;
+	Sint32 encoded_len;
+	Uint32 block_len;
+
 	/* Allocate the proper sized output buffer */
 	encoded_len = *audio_len;
 	encoded = *audio_buf;
 	freeable = *audio_buf;
-	*audio_len = (encoded_len/MS_ADPCM_state.wavefmt.blockalign) * 
-				MS_ADPCM_state.wSamplesPerBlock*
-				MS_ADPCM_state.wavefmt.channels*sizeof(Sint16);
+	block_len = decoder->wSamplesPerBlock*
+				decoder->wavefmt.channels*sizeof(Sint16);
+	*audio_len = (encoded_len/decoder->wavefmt.blockalign) *
+				block_len;
 	*audio_buf = (Uint8 *)SDL_malloc(*audio_len);
 	if ( *audio_buf == NULL ) {
 		SDL_Error(SDL_ENOMEM);
@@ -136,76 +226,11 @@ static int MS_ADPCM_decode(Uint8 **audio_buf, Uint32 *audio_len)
 	decoded = *audio_buf;
 
 	/* Get ready... Go! */
-	stereo = (MS_ADPCM_state.wavefmt.channels == 2);
-	state[0] = &MS_ADPCM_state.state[0];
-	state[1] = &MS_ADPCM_state.state[stereo];
-	while ( encoded_len >= MS_ADPCM_state.wavefmt.blockalign ) {
-		/* Grab the initial information for this block */
-		state[0]->hPredictor = *encoded++;
-		if ( stereo ) {
-			state[1]->hPredictor = *encoded++;
-		}
-		state[0]->iDelta = ((encoded[1]<<8)|encoded[0]);
-		encoded += sizeof(Sint16);
-		if ( stereo ) {
-			state[1]->iDelta = ((encoded[1]<<8)|encoded[0]);
-			encoded += sizeof(Sint16);
-		}
-		state[0]->iSamp1 = ((encoded[1]<<8)|encoded[0]);
-		encoded += sizeof(Sint16);
-		if ( stereo ) {
-			state[1]->iSamp1 = ((encoded[1]<<8)|encoded[0]);
-			encoded += sizeof(Sint16);
-		}
-		state[0]->iSamp2 = ((encoded[1]<<8)|encoded[0]);
-		encoded += sizeof(Sint16);
-		if ( stereo ) {
-			state[1]->iSamp2 = ((encoded[1]<<8)|encoded[0]);
-			encoded += sizeof(Sint16);
-		}
-		coeff[0] = MS_ADPCM_state.aCoeff[state[0]->hPredictor];
-		coeff[1] = MS_ADPCM_state.aCoeff[state[1]->hPredictor];
-
-		/* Store the two initial samples we start with */
-		decoded[0] = state[0]->iSamp2&0xFF;
-		decoded[1] = state[0]->iSamp2>>8;
-		decoded += 2;
-		if ( stereo ) {
-			decoded[0] = state[1]->iSamp2&0xFF;
-			decoded[1] = state[1]->iSamp2>>8;
-			decoded += 2;
-		}
-		decoded[0] = state[0]->iSamp1&0xFF;
-		decoded[1] = state[0]->iSamp1>>8;
-		decoded += 2;
-		if ( stereo ) {
-			decoded[0] = state[1]->iSamp1&0xFF;
-			decoded[1] = state[1]->iSamp1>>8;
-			decoded += 2;
-		}
-
-		/* Decode and store the other samples in this block */
-		samplesleft = (MS_ADPCM_state.wSamplesPerBlock-2)*
-					MS_ADPCM_state.wavefmt.channels;
-		while ( samplesleft > 0 ) {
-			nybble = (*encoded)>>4;
-			new_sample = MS_ADPCM_nibble(state[0],nybble,coeff[0]);
-			decoded[0] = new_sample&0xFF;
-			new_sample >>= 8;
-			decoded[1] = new_sample&0xFF;
-			decoded += 2;
-
-			nybble = (*encoded)&0x0F;
-			new_sample = MS_ADPCM_nibble(state[1],nybble,coeff[1]);
-			decoded[0] = new_sample&0xFF;
-			new_sample >>= 8;
-			decoded[1] = new_sample&0xFF;
-			decoded += 2;
-
-			++encoded;
-			samplesleft -= 2;
-		}
-		encoded_len -= MS_ADPCM_state.wavefmt.blockalign;
+	while ( encoded_len >= decoder->wavefmt.blockalign ) {
+		MS_ADPCM_decode_block(decoder, encoded, decoded);
+		encoded += decoder->wavefmt.blockalign;
+		encoded_len -= decoder->wavefmt.blockalign;
+		decoded += block_len;
 	}
 	SDL_free(freeable);
 	return(0);
@@ -215,30 +240,46 @@ struct IMA_ADPCM_decodestate {
 	Sint32 sample;
 	Sint8 index;
 };
-static struct IMA_ADPCM_decoder {
+struct IMA_ADPCM_decoder {
 	WaveFMT wavefmt;
 	Uint16 wSamplesPerBlock;
 	/* * * */
 	struct IMA_ADPCM_decodestate state[2];
-} IMA_ADPCM_state;
+};
 
-static int InitIMA_ADPCM(WaveFMT *format)
+static int InitIMA_ADPCM(struct IMA_ADPCM_decoder *decoder, WaveFMT *format)
 {
 	Uint8 *rogue_feel;
 
 	/* Set the rogue pointer to the IMA_ADPCM specific data */
-	IMA_ADPCM_state.wavefmt.encoding = SDL_SwapLE16(format->encoding);
-	IMA_ADPCM_state.wavefmt.channels = SDL_SwapLE16(format->channels);
-	IMA_ADPCM_state.wavefmt.frequency = SDL_SwapLE32(format->frequency);
-	IMA_ADPCM_state.wavefmt.byterate = SDL_SwapLE32(format->byterate);
-	IMA_ADPCM_state.wavefmt.blockalign = SDL_SwapLE16(format->blockalign);
-	IMA_ADPCM_state.wavefmt.bitspersample =
+	decoder->wavefmt.encoding = SDL_SwapLE16(format->encoding);
+	decoder->wavefmt.channels = SDL_SwapLE16(format->channels);
+	decoder->wavefmt.frequency = SDL_SwapLE32(format->frequency);
+	decoder->wavefmt.byterate = SDL_SwapLE32(format->byterate);
+	decoder->wavefmt.blockalign = SDL_SwapLE16(format->blockalign);
+	decoder->wavefmt.bitspersample =
 					 SDL_SwapLE16(format->bitspersample);
 	rogue_feel = (Uint8 *)format+sizeof(*format);
 	if ( sizeof(*format) == 16 ) {
 		rogue_feel += sizeof(Uint16);
 	}
-	IMA_ADPCM_state.wSamplesPerBlock = ((rogue_feel[1]<<8)|rogue_feel[0]);
+	decoder->wSamplesPerBlock = ((rogue_feel[1]<<8)|rogue_feel[0]);
+
+	/* Check to make sure we have enough variables in the state array */
+	if ( (decoder->wavefmt.channels < 1) ||
+	     (decoder->wavefmt.channels > SDL_arraysize(decoder->state)) ) {
+		SDL_SetError("IMA ADPCM decoder can only handle %d channels",
+					SDL_arraysize(decoder->state));
+		return(-1);
+	}
+	/* Each block must hold its header and all of its samples */
+	if ( (decoder->wSamplesPerBlock < 1) ||
+	     ((decoder->wSamplesPerBlock-1) % 8) ||
+	     (decoder->wavefmt.blockalign < 4*decoder->wavefmt.channels +
+	      (decoder->wSamplesPerBlock-1)*decoder->wavefmt.channels/2) ) {
+		SDL_SetError("Invalid IMA ADPCM block size");
+		return(-1);
+	}
 	return(0);
 }
 
@@ -293,7 +334,7 @@ static Sint32 IMA_ADPCM_nibble(struct IMA_ADPCM_decodestate *state,Uint8 nybble)
 }
 
 /* Fill the decode buffer with a channel block of data (8 samples) */
-static void Fill_IMA_ADPCM_block(Uint8 *decoded, Uint8 *encoded,
+static void Fill_IMA_ADPCM_block(Uint8 *decoded, const Uint8 *encoded,
 	int channel, int numchannels, struct IMA_ADPCM_decodestate *state)
 {
 	int i;
@@ -320,29 +361,69 @@ static void Fill_IMA_ADPCM_block(Uint8 *decoded, Uint8 *encoded,
 	}
 }
 
-static int IMA_ADPCM_decode(Uint8 **audio_buf, Uint32 *audio_len)
+/* Decode one block of encoded data into wSamplesPerBlock sample frames */
+static void IMA_ADPCM_decode_block(struct IMA_ADPCM_decoder *decoder,
+				const Uint8 *encoded, Uint8 *decoded)
 {
 	struct IMA_ADPCM_decodestate *state;
-	Uint8 *freeable, *encoded, *decoded;
-	Sint32 encoded_len, samplesleft;
+	Sint32 samplesleft;
 	unsigned int c, channels;
 
-	/* Check to make sure we have enough variables in the state array */
-	channels = IMA_ADPCM_state.wavefmt.channels;
-	if ( channels > SDL_arraysize(IMA_ADPCM_state.state) ) {
-		SDL_SetError("IMA ADPCM decoder can only handle %d channels",
-					SDL_arraysize(IMA_ADPCM_state.state));
-		return(-1);
+	channels = decoder->wavefmt.channels;
+	state = decoder->state;
+
+	/* Grab the initial information for this block */
+	for ( c=0; c<channels; ++c ) {
+		/* Fill the state information for this block */
+		state[c].sample = ((encoded[1]<<8)|encoded[0]);
+		encoded += 2;
+		if ( state[c].sample & 0x8000 ) {
+			state[c].sample -= 0x10000;
+		}
+		state[c].index = *encoded++;
+		if ( (Uint8)state[c].index > 88 ) {
+			/* Corrupt data, keep the step table in bounds */
+			state[c].index = 88;
+		}
+		/* Reserved byte in buffer header, should be 0 */
+		if ( *encoded++ != 0 ) {
+			/* Uh oh, corrupt data?  Buggy code? */;
+		}
+
+		/* Store the initial sample we start with */
+		decoded[0] = (Uint8)(state[c].sample&0xFF);
+		decoded[1] = (Uint8)(state[c].sample>>8);
+		decoded += 2;
 	}
-	state = IMA_ADPCM_state.state;
+
+	/* Decode and store the other samples in this block */
+	samplesleft = (decoder->wSamplesPerBlock-1)*channels;
+	while ( samplesleft > 0 ) {
+		for ( c=0; c<channels; ++c ) {
+			Fill_IMA_ADPCM_block(decoded, encoded,
+					c, channels, &state[c]);
+			encoded += 4;
+			samplesleft -= 8;
+		}
+		decoded += (channels * 8 * 2);
+	}
+}
+
+static int IMA_ADPCM_decode(struct IMA_ADPCM_decoder *decoder,
+				Uint8 **audio_buf, Uint32 *audio_len)
+{
+	Uint8 *freeable, *encoded, *decoded;
+	Sint32 encoded_len;
+	Uint32 block_len;
 
 	/* Allocate the proper sized output buffer */
 	encoded_len = *audio_len;
 	encoded = *audio_buf;
 	freeable = *audio_buf;
-	*audio_len = (encoded_len/IMA_ADPCM_state.wavefmt.blockalign) * 
-				IMA_ADPCM_state.wSamplesPerBlock*
-				IMA_ADPCM_state.wavefmt.channels*sizeof(Sint16);
+	block_len = decoder->wSamplesPerBlock*
+				decoder->wavefmt.channels*sizeof(Sint16);
+	*audio_len = (encoded_len/decoder->wavefmt.blockalign) *
+				block_len;
 	*audio_buf = (Uint8 *)SDL_malloc(*audio_len);
 	if ( *audio_buf == NULL ) {
 		SDL_Error(SDL_ENOMEM);
@@ -351,85 +432,43 @@ static int IMA_ADPCM_decode(Uint8 **audio_buf, Uint32 *audio_len)
 	decoded = *audio_buf;
 
 	/* Get ready... Go! */
-	while ( encoded_len >= IMA_ADPCM_state.wavefmt.blockalign ) {
-		/* Grab the initial information for this block */
-		for ( c=0; c<channels; ++c ) {
-			/* Fill the state information for this block */
-			state[c].sample = ((encoded[1]<<8)|encoded[0]);
-			encoded += 2;
-			if ( state[c].sample & 0x8000 ) {
-				state[c].sample -= 0x10000;
-			}
-			state[c].index = *encoded++;
-			/* Reserved byte in buffer header, should be 0 */
-			if ( *encoded++ != 0 ) {
-				/* Uh oh, corrupt data?  Buggy code? */;
-			}
-
-			/* Store the initial sample we start with */
-			decoded[0] = (Uint8)(state[c].sample&0xFF);
-			decoded[1] = (Uint8)(state[c].sample>>8);
-			decoded += 2;
-		}
-
-		/* Decode and store the other samples in this block */
-		samplesleft = (IMA_ADPCM_state.wSamplesPerBlock-1)*channels;
-		while ( samplesleft > 0 ) {
-			for ( c=0; c<channels; ++c ) {
-				Fill_IMA_ADPCM_block(decoded, encoded,
-						c, channels, &state[c]);
-				encoded += 4;
-				samplesleft -= 8;
-			}
-			decoded += (channels * 8 * 2);
-		}
-		encoded_len -= IMA_ADPCM_state.wavefmt.blockalign;
+	while ( encoded_len >= decoder->wavefmt.blockalign ) {
+		IMA_ADPCM_decode_block(decoder, encoded, decoded);
+		encoded += decoder->wavefmt.blockalign;
+		encoded_len -= decoder->wavefmt.blockalign;
+		decoded += block_len;
 	}
 	SDL_free(freeable);
 	return(0);
 }
 
-SDL_AudioSpec * SDL_LoadWAV_RW (SDL_RWops *src, int freesrc,
-		SDL_AudioSpec *spec, Uint8 **audio_buf, Uint32 *audio_len)
+/* Check the RIFF header and read the chunks up to the format chunk.
+   Returns the format chunk, to be freed by the caller, or NULL.
+*/
+static WaveFMT *ReadWaveFMT(SDL_RWops *src, Uint32 *wavelen, Uint32 *headerDiff)
 {
-	int was_error;
 	Chunk chunk;
 	int lenread;
-	int MS_ADPCM_encoded, IMA_ADPCM_encoded;
-	int samplesize;
 
 	/* WAV magic header */
 	Uint32 RIFFchunk;
-	Uint32 wavelen = 0;
 	Uint32 WAVEmagic;
-	Uint32 headerDiff = 0;
 
-	/* FMT chunk */
-	WaveFMT *format = NULL;
-
-	/* Make sure we are passed a valid data source */
-	was_error = 0;
-	if ( src == NULL ) {
-		was_error = 1;
-		goto done;
-	}
-		
 	/* Check the magic header */
 	RIFFchunk	= SDL_ReadLE32(src);
-	wavelen		= SDL_ReadLE32(src);
-	if ( wavelen == WAVE ) { /* The RIFFchunk has already been read */
-		WAVEmagic = wavelen;
-		wavelen   = RIFFchunk;
+	*wavelen	= SDL_ReadLE32(src);
+	if ( *wavelen == WAVE ) { /* The RIFFchunk has already been read */
+		WAVEmagic = *wavelen;
+		*wavelen  = RIFFchunk;
 		RIFFchunk = RIFF;
 	} else {
 		WAVEmagic = SDL_ReadLE32(src);
 	}
 	if ( (RIFFchunk != RIFF) || (WAVEmagic != WAVE) ) {
 		SDL_SetError("Unrecognized file type (not WAVE)");
-		was_error = 1;
-		goto done;
+		return(NULL);
 	}
-	headerDiff += sizeof(Uint32); /* for WAVE */
+	*headerDiff += sizeof(Uint32); /* for WAVE */
 
 	/* Read the audio data format chunk */
 	chunk.data = NULL;
@@ -440,57 +479,61 @@ SDL_AudioSpec * SDL_LoadWAV_RW (SDL_RWops *src, int freesrc,
 		}
 		lenread = ReadChunk(src, &chunk);
 		if ( lenread < 0 ) {
-			was_error = 1;
-			goto done;
+			return(NULL);
 		}
 		/* 2 Uint32's for chunk header+len, plus the lenread */
-		headerDiff += lenread + 2 * sizeof(Uint32);
+		*headerDiff += lenread + 2 * sizeof(Uint32);
 	} while ( (chunk.magic == FACT) || (chunk.magic == LIST) );
 
-	/* Decode the audio data format */
-	format = (WaveFMT *)chunk.data;
 	if ( chunk.magic != FMT ) {
 		SDL_SetError("Complex WAVE files not supported");
-		was_error = 1;
-		goto done;
+		SDL_free(chunk.data);
+		return(NULL);
 	}
-	MS_ADPCM_encoded = IMA_ADPCM_encoded = 0;
-	switch (SDL_SwapLE16(format->encoding)) {
+	return((WaveFMT *)chunk.data);
+}
+
+/* Set up the decoder for the audio data format, and fill in the spec
+   of the decoded audio.  Returns the encoding, or -1 on error.
+*/
+static int InitWaveSpec(WaveFMT *format, SDL_AudioSpec *spec,
+	struct MS_ADPCM_decoder *ms, struct IMA_ADPCM_decoder *ima)
+{
+	int encoding;
+	int was_error = 0;
+
+	/* Decode the audio data format */
+	encoding = SDL_SwapLE16(format->encoding);
+	switch (encoding) {
 		case PCM_CODE:
 			/* We can understand this */
 			break;
 		case MS_ADPCM_CODE:
 			/* Try to understand this */
-			if ( InitMS_ADPCM(format) < 0 ) {
-				was_error = 1;
-				goto done;
+			if ( InitMS_ADPCM(ms, format) < 0 ) {
+				return(-1);
 			}
-			MS_ADPCM_encoded = 1;
 			break;
 		case IMA_ADPCM_CODE:
 			/* Try to understand this */
-			if ( InitIMA_ADPCM(format) < 0 ) {
-				was_error = 1;
-				goto done;
+			if ( InitIMA_ADPCM(ima, format) < 0 ) {
+				return(-1);
 			}
-			IMA_ADPCM_encoded = 1;
 			break;
 		case MP3_CODE:
 			SDL_SetError("MPEG Layer 3 data not supported",
 					SDL_SwapLE16(format->encoding));
-			was_error = 1;
-			goto done;
+			return(-1);
 		default:
 			SDL_SetError("Unknown WAVE data format: 0x%.4x",
 					SDL_SwapLE16(format->encoding));
-			was_error = 1;
-			goto done;
+			return(-1);
 	}
 	SDL_memset(spec, 0, (sizeof *spec));
 	spec->freq = SDL_SwapLE32(format->frequency);
 	switch (SDL_SwapLE16(format->bitspersample)) {
 		case 4:
-			if ( MS_ADPCM_encoded || IMA_ADPCM_encoded ) {
+			if ( encoding != PCM_CODE ) {
 				spec->format = AUDIO_S16;
 			} else {
 				was_error = 1;
@@ -509,10 +552,50 @@ SDL_AudioSpec * SDL_LoadWAV_RW (SDL_RWops *src, int freesrc,
 	if ( was_error ) {
 		SDL_SetError("Unknown %d-bit PCM data format",
 			SDL_SwapLE16(format->bitspersample));
-		goto done;
+		return(-1);
 	}
 	spec->channels = (Uint8)SDL_SwapLE16(format->channels);
 	spec->samples = 4096;		/* Good default buffer size */
+	return(encoding);
+}
+
+SDL_AudioSpec * SDL_LoadWAV_RW (SDL_RWops *src, int freesrc,
+		SDL_AudioSpec *spec, Uint8 **audio_buf, Uint32 *audio_len)
+{
+	int was_error;
+	Chunk chunk;
+	int lenread;
+	int encoding;
+	int samplesize;
+
+	/* WAV magic header */
+	Uint32 wavelen = 0;
+	Uint32 headerDiff = 0;
+
+	/* FMT chunk */
+	WaveFMT *format = NULL;
+	struct MS_ADPCM_decoder ms_decoder;
+	struct IMA_ADPCM_decoder ima_decoder;
+
+	/* Make sure we are passed a valid data source */
+	was_error = 0;
+	chunk.length = 0;
+	if ( src == NULL ) {
+		was_error = 1;
+		goto done;
+	}
+
+	/* Check the magic header and the audio data format */
+	format = ReadWaveFMT(src, &wavelen, &headerDiff);
+	if ( format == NULL ) {
+		was_error = 1;
+		goto done;
+	}
+	encoding = InitWaveSpec(format, spec, &ms_decoder, &ima_decoder);
+	if ( encoding < 0 ) {
+		was_error = 1;
+		goto done;
+	}
 
 	/* Read the audio data chunk */
 	*audio_buf = NULL;
@@ -532,14 +615,14 @@ SDL_AudioSpec * SDL_LoadWAV_RW (SDL_RWops *src, int freesrc,
 	} while ( chunk.magic != DATA );
 	headerDiff += 2 * sizeof(Uint32); /* for the data chunk and len */
 
-	if ( MS_ADPCM_encoded ) {
-		if ( MS_ADPCM_decode(audio_buf, audio_len) < 0 ) {
+	if ( encoding == MS_ADPCM_CODE ) {
+		if ( MS_ADPCM_decode(&ms_decoder, audio_buf, audio_len) < 0 ) {
 			was_error = 1;
 			goto done;
 		}
 	}
-	if ( IMA_ADPCM_encoded ) {
-		if ( IMA_ADPCM_decode(audio_buf, audio_len) < 0 ) {
+	if ( encoding == IMA_ADPCM_CODE ) {
+		if ( IMA_ADPCM_decode(&ima_decoder, audio_buf, audio_len) < 0 ) {
 			was_error = 1;
 			goto done;
 		}
@@ -567,6 +650,275 @@ done:
 	return(spec);
 }
 
+/* A WAVE data source that is decoded as it is read, a block at a time */
+typedef struct WaveStream {
+	SDL_RWops *src;
+	int freesrc;
+	int encoding;
+	int data_start;		/* Offset of the encoded data in src */
+	Uint32 src_pos;		/* Offset src is at, from data_start */
+	Uint32 blockalign;	/* Encoded bytes per block */
+	Uint32 block_len;	/* Decoded bytes per block */
+	Uint32 decoded_len;	/* Decoded bytes in the whole stream */
+	Uint32 pos;		/* Decoded bytes read so far */
+	Uint32 block;		/* The block held in 'decoded' */
+	Uint8 *encoded;
+	Uint8 *decoded;
+	struct MS_ADPCM_decoder ms;
+	struct IMA_ADPCM_decoder ima;
+} WaveStream;
+
+/* Read encoded data from an offset into the data chunk */
+static int ReadWaveData(WaveStream *stream, Uint32 offset, void *ptr, int len)
+{
+	int got;
+
+	if ( stream->src_pos != offset ) {
+		if ( SDL_RWseek(stream->src, stream->data_start+offset,
+		                RW_SEEK_SET) < 0 ) {
+			return(-1);
+		}
+		stream->src_pos = offset;
+	}
+	got = SDL_RWread(stream->src, ptr, 1, len);
+	if ( got > 0 ) {
+		stream->src_pos += got;
+	}
+	return(got);
+}
+
+/* Get an encoded block, in place if the source is backed by memory */
+static const Uint8 *GetWaveBlock(WaveStream *stream, Uint32 block)
+{
+	Uint32 offset = block*stream->blockalign;
+	const Uint8 *mem;
+	int avail = 0;
+
+	mem = SDL_RWGetMemory(stream->src, &avail);
+	if ( mem ) {
+		/* Memory seeks are cheap, so find the block directly */
+		SDL_RWseek(stream->src, stream->data_start+offset, RW_SEEK_SET);
+		stream->src_pos = offset;
+		mem = SDL_RWGetMemory(stream->src, &avail);
+	}
+	if ( mem && ((Uint32)avail >= stream->blockalign) ) {
+		SDL_RWseek(stream->src, stream->blockalign, RW_SEEK_CUR);
+		stream->src_pos += stream->blockalign;
+		return(mem);
+	}
+	if ( ReadWaveData(stream, offset, stream->encoded,
+	                  stream->blockalign) != (int)stream->blockalign ) {
+		return(NULL);
+	}
+	return(stream->encoded);
+}
+
+static int SDLCALL wave_seek(SDL_RWops *context, int offset, int whence)
+{
+	WaveStream *stream = (WaveStream *)context->hidden.unknown.data1;
+	int pos;
+
+	switch (whence) {
+		case RW_SEEK_SET:
+			pos = offset;
+			break;
+		case RW_SEEK_CUR:
+			pos = stream->pos + offset;
+			break;
+		case RW_SEEK_END:
+			pos = stream->decoded_len + offset;
+			break;
+		default:
+			SDL_SetError("Unknown value for 'whence'");
+			return(-1);
+	}
+	if ( pos < 0 ) {
+		pos = 0;
+	}
+	if ( (Uint32)pos > stream->decoded_len ) {
+		pos = stream->decoded_len;
+	}
+	stream->pos = pos;
+	return(pos);
+}
+
+static int SDLCALL wave_read(SDL_RWops *context, void *ptr, int size, int maxnum)
+{
+	WaveStream *stream = (WaveStream *)context->hidden.unknown.data1;
+	Uint8 *dst = (Uint8 *)ptr;
+	const Uint8 *encoded;
+	Uint32 len, left, block, offset, chunk;
+	int got;
+
+	if ( (size <= 0) || (maxnum <= 0) ) {
+		return(0);
+	}
+	left = stream->decoded_len - stream->pos;
+	len = ((Uint32)size * maxnum > left) ? left : (Uint32)size * maxnum;
+	len -= len % size;
+
+	if ( stream->encoding == PCM_CODE ) {
+		got = ReadWaveData(stream, stream->pos, dst, len);
+		if ( got < 0 ) {
+			return(-1);
+		}
+		stream->pos += got;
+		return(got / size);
+	}
+
+	/* Decode whole blocks, and copy out the part that's wanted */
+	for ( left=len; left; left-=chunk, dst+=chunk ) {
+		block = stream->pos / stream->block_len;
+		offset = stream->pos % stream->block_len;
+		if ( block != stream->block ) {
+			encoded = GetWaveBlock(stream, block);
+			if ( !encoded ) {
+				SDL_Error(SDL_EFREAD);
+				break;
+			}
+			if ( stream->encoding == MS_ADPCM_CODE ) {
+				MS_ADPCM_decode_block(&stream->ms,
+				             encoded, stream->decoded);
+			} else {
+				IMA_ADPCM_decode_block(&stream->ima,
+				             encoded, stream->decoded);
+			}
+			stream->block = block;
+		}
+		chunk = stream->block_len - offset;
+		if ( chunk > left ) {
+			chunk = left;
+		}
+		SDL_memcpy(dst, stream->decoded+offset, chunk);
+		stream->pos += chunk;
+	}
+	if ( (left == len) && (len > 0) ) {
+		return(-1);
+	}
+	return((len - left) / size);
+}
+
+static int SDLCALL wave_write(SDL_RWops *context, const void *ptr, int size, int num)
+{
+	SDL_SetError("Can't write to a WAVE stream");
+	return(-1);
+}
+
+static int SDLCALL wave_close(SDL_RWops *context)
+{
+	WaveStream *stream;
+
+	if ( context ) {
+		stream = (WaveStream *)context->hidden.unknown.data1;
+		if ( stream->freesrc ) {
+			SDL_RWclose(stream->src);
+		}
+		SDL_free(stream->encoded);
+		SDL_free(stream->decoded);
+		SDL_free(stream);
+		SDL_FreeRW(context);
+	}
+	return(0);
+}
+
+SDL_RWops * SDL_RWFromWAV(SDL_RWops *src, int freesrc, SDL_AudioSpec *spec)
+{
+	WaveStream *stream = NULL;
+	SDL_RWops *rwops = NULL;
+	WaveFMT *format = NULL;
+	Uint32 wavelen, headerDiff = 0;
+	Uint32 header[2], magic, length;
+	int samplesize;
+
+	if ( src == NULL ) {
+		SDL_SetError("SDL_RWFromWAV() passed a NULL data source");
+		return(NULL);
+	}
+	stream = (WaveStream *)SDL_calloc(1, sizeof(*stream));
+	if ( stream == NULL ) {
+		SDL_OutOfMemory();
+		goto error;
+	}
+	stream->src = src;
+	stream->freesrc = freesrc;
+
+	/* Check the magic header and the audio data format */
+	format = ReadWaveFMT(src, &wavelen, &headerDiff);
+	if ( format == NULL ) {
+		goto error;
+	}
+	stream->encoding = InitWaveSpec(format, spec, &stream->ms, &stream->ima);
+	if ( stream->encoding < 0 ) {
+		goto error;
+	}
+	samplesize = ((spec->format & 0xFF)/8)*spec->channels;
+
+	/* Find the audio data chunk, without reading it */
+	for ( ;; ) {
+		if ( SDL_RWread(src, header, sizeof(header), 1) != 1 ) {
+			SDL_SetError("No audio data in WAVE file");
+			goto error;
+		}
+		magic = SDL_SwapLE32(header[0]);
+		length = SDL_SwapLE32(header[1]);
+		if ( magic == DATA ) {
+			break;
+		}
+		if ( SDL_RWseek(src, length, RW_SEEK_CUR) < 0 ) {
+			goto error;
+		}
+	}
+	stream->data_start = SDL_RWtell(src);
+
+	if ( stream->encoding == PCM_CODE ) {
+		stream->decoded_len = length - (length % samplesize);
+	} else {
+		stream->blockalign = SDL_SwapLE16(format->blockalign);
+		if ( stream->encoding == MS_ADPCM_CODE ) {
+			stream->block_len = stream->ms.wSamplesPerBlock;
+		} else {
+			stream->block_len = stream->ima.wSamplesPerBlock;
+		}
+		stream->block_len *= samplesize;
+		stream->decoded_len = (length / stream->blockalign) *
+		                      stream->block_len;
+		stream->block = (Uint32)-1;
+		stream->encoded = (Uint8 *)SDL_malloc(stream->blockalign);
+		stream->decoded = (Uint8 *)SDL_malloc(stream->block_len);
+		if ( !stream->encoded || !stream->decoded ) {
+			SDL_OutOfMemory();
+			goto error;
+		}
+	}
+	SDL_free(format);
+	format = NULL;
+
+	rwops = SDL_AllocRW();
+	if ( rwops == NULL ) {
+		goto error;
+	}
+	rwops->seek = wave_seek;
+	rwops->read = wave_read;
+	rwops->write = wave_write;
+	rwops->close = wave_close;
+	rwops->hidden.unknown.data1 = stream;
+	return(rwops);
+
+error:
+	if ( format != NULL ) {
+		SDL_free(format);
+	}
+	if ( stream != NULL ) {
+		SDL_free(stream->encoded);
+		SDL_free(stream->decoded);
+		SDL_free(stream);
+	}
+	if ( freesrc ) {
+		SDL_RWclose(src);
+	}
+	return(NULL);
+}
+
 /* Since the WAV memory is allocated in the shared library, it must also
    be freed here.  (Necessary under Win32, VC++)
  */
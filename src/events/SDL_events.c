@@ -32,6 +32,14 @@
 #include "../joystick/SDL_joystick_c.h"
 #endif
 
+/* SDL_WaitEvent() sleeps in poll() instead of checking every 10 ms */
+#if defined(__LINUX__) && !SDL_THREADS_DISABLED
+#define SDL_EVENT_WAKEUP	1
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
 /* Public data -- the event filter */
 SDL_EventFilter SDL_EventOK = NULL;
 Uint8 SDL_ProcessEvents[SDL_NUMEVENTS];
@@ -39,22 +47,135 @@ static Uint32 SDL_eventstate = 0;
 
 /* Private data -- event queue */
 #define MAXEVENTS	128
+#define MAXQUEUESIZE	4096	/* Default limit, see SDL_EVENT_QUEUE_SIZE */
+
+/* Events removed from the middle of the queue are marked with this type
+   and skipped, instead of shifting the rest of the queue over them.
+ */
+#define SDL_DEADEVENT	SDL_NUMEVENTS
+
 static struct {
 	SDL_mutex *lock;
 	int active;
 	int head;
 	int tail;
-	SDL_Event event[MAXEVENTS];
-	int wmmsg_next;
-	struct SDL_SysWMmsg wmmsg[MAXEVENTS];
+	int size;		/* Number of slots in event, one is kept free */
+	int max_size;
+	int dead;		/* Number of cut events between head and tail */
+	int waiting;		/* Number of threads asleep in SDL_WaitEvent() */
+	Uint32 dropped;
+	SDL_Event *event;
+	SDL_Event static_event[MAXEVENTS];
+	/* The messages of SDL_SYSWMEVENTs, kept in the slot of their event */
+	struct SDL_SysWMmsg *wmmsg;
+	struct SDL_SysWMmsg static_wmmsg[MAXEVENTS];
 } SDL_EventQ;
 
 /* Private data -- event locking structure */
 static struct {
-	SDL_mutex *lock;
-	int safe;
+	SDL_mutex *lock;	/* Held by the thread that locked the event thread */
+	SDL_mutex *state_lock;
+	SDL_cond *state_cond;
+	int safe;		/* The event thread is parked between pumps */
+	int requests;		/* Nesting count of SDL_Lock_EventThread() */
 } SDL_EventLock;
 
+#if SDL_EVENT_WAKEUP
+/* Readable when an event was added while someone was waiting */
+static int SDL_EventWakeup = -1;
+/* Readable when the event thread should recheck what it's waiting for */
+static int SDL_EventThreadWakeup = -1;
+
+#define MAXWAITFDS	16
+
+static int SDL_CreateWakeup(void)
+{
+	return(eventfd(0, EFD_NONBLOCK|EFD_CLOEXEC));
+}
+
+static void SDL_SetWakeup(int fd)
+{
+	Uint64 one = 1;
+
+	if ( write(fd, &one, sizeof(one)) < 0 ) {
+		/* The counter is saturated, so it's readable anyway */
+	}
+}
+
+static void SDL_ClearWakeup(int fd)
+{
+	Uint64 count;
+
+	if ( read(fd, &count, sizeof(count)) < 0 ) {
+		/* Nothing was written, it's already clear */
+	}
+}
+
+static void SDL_CloseWakeup(int *fd)
+{
+	if ( *fd >= 0 ) {
+		close(*fd);
+		*fd = -1;
+	}
+}
+
+/* Lower a poll() timeout, where -1 means forever */
+static void SDL_LowerTimeout(int *timeout, int when)
+{
+	if ( (*timeout < 0) || (when < *timeout) ) {
+		*timeout = when;
+	}
+}
+
+/* Add the descriptors SDL_PumpEvents() reads from to 'fds', and lower
+   'timeout' to when anything it has to poll for is due.
+ */
+static int SDL_GetEventSources(struct pollfd *fds, int nfds, int *timeout)
+{
+	SDL_VideoDevice *video = current_video;
+	SDL_VideoDevice *this  = current_video;
+	int repeat;
+
+	if ( video ) {
+		int fd = -1;
+
+		if ( video->GetEventFD ) {
+			fd = video->GetEventFD(this, timeout);
+		}
+		if ( fd >= 0 ) {
+			fds[nfds].fd = fd;
+			fds[nfds].events = POLLIN;
+			++nfds;
+		} else {
+			SDL_LowerTimeout(timeout, 10);
+		}
+	}
+
+	repeat = SDL_KeyRepeatTimeout();
+	if ( repeat >= 0 ) {
+		SDL_LowerTimeout(timeout, repeat);
+	}
+
+#if !SDL_JOYSTICK_DISABLED
+	if ( SDL_numjoysticks && (SDL_eventstate & SDL_JOYEVENTMASK) ) {
+		int joyfds[MAXWAITFDS];
+		int i, numjoyfds;
+
+		numjoyfds = SDL_JoystickGetFDs(joyfds, MAXWAITFDS-nfds);
+		if ( numjoyfds < 0 ) {
+			SDL_LowerTimeout(timeout, 10);
+		}
+		for ( i=0; i<numjoyfds; ++i ) {
+			fds[nfds].fd = joyfds[i];
+			fds[nfds].events = POLLIN;
+			++nfds;
+		}
+	}
+#endif
+	return(nfds);
+}
+#endif /* SDL_EVENT_WAKEUP */
+
 /* Thread functions */
 static SDL_Thread *SDL_EventThread = NULL;	/* Thread handle */
 static Uint32 event_thread;			/* The event thread id */
@@ -62,20 +183,42 @@ static Uint32 event_thread;			/* The event thread id */
 void SDL_Lock_EventThread(void)
 {
 	if ( SDL_EventThread && (SDL_ThreadID() != event_thread) ) {
-		/* Grab lock and spin until we're sure event thread stopped */
+		/* Grab the lock and wait until the event thread is parked */
 		SDL_mutexP(SDL_EventLock.lock);
+		SDL_mutexP(SDL_EventLock.state_lock);
+		++SDL_EventLock.requests;
 		while ( ! SDL_EventLock.safe ) {
-			SDL_Delay(1);
+			SDL_CondWait(SDL_EventLock.state_cond,
+			             SDL_EventLock.state_lock);
 		}
+		SDL_mutexV(SDL_EventLock.state_lock);
 	}
 }
 void SDL_Unlock_EventThread(void)
 {
 	if ( SDL_EventThread && (SDL_ThreadID() != event_thread) ) {
+		SDL_mutexP(SDL_EventLock.state_lock);
+		if ( --SDL_EventLock.requests == 0 ) {
+			SDL_CondBroadcast(SDL_EventLock.state_cond);
+		}
+		SDL_mutexV(SDL_EventLock.state_lock);
+#if SDL_EVENT_WAKEUP
+		/* We may have opened joysticks, changed video mode, etc. */
+		SDL_WakeEventThread();
+#endif
 		SDL_mutexV(SDL_EventLock.lock);
 	}
 }
 
+void SDL_WakeEventThread(void)
+{
+#if SDL_EVENT_WAKEUP
+	if ( SDL_EventThreadWakeup >= 0 ) {
+		SDL_SetWakeup(SDL_EventThreadWakeup);
+	}
+#endif
+}
+
 #ifdef __OS2__
 /*
  * We'll increase the priority of GobbleEvents thread, so it will process
@@ -87,6 +230,37 @@ void SDL_Unlock_EventThread(void)
 #include <time.h>
 #endif
 
+/* Sleep until the event thread has something to do -- called while parked */
+static void SDL_EventThreadSleep(void)
+{
+#if SDL_EVENT_WAKEUP
+	struct pollfd fds[MAXWAITFDS];
+	int nfds, timeout;
+
+	if ( SDL_EventThreadWakeup < 0 ) {
+		SDL_Delay(1);
+		return;
+	}
+	nfds = 0;
+	fds[nfds].fd = SDL_EventThreadWakeup;
+	fds[nfds].events = POLLIN;
+	++nfds;
+	timeout = -1;
+	if ( SDL_timer_running ) {
+		timeout = SDL_ThreadedTimerTimeout();
+	}
+	nfds = SDL_GetEventSources(fds, nfds, &timeout);
+
+	/* Any error, EINTR included, just sends us around the loop again */
+	if ( timeout != 0 ) {
+		poll(fds, nfds, timeout);
+		SDL_ClearWakeup(SDL_EventThreadWakeup);
+	}
+#else
+	SDL_Delay(1);
+#endif
+}
+
 static int SDLCALL SDL_GobbleEvents(void *unused)
 {
 	event_thread = SDL_ThreadID();
@@ -117,24 +291,29 @@ static int SDLCALL SDL_GobbleEvents(void *unused)
 		}
 #endif
 
-		/* Give up the CPU for the rest of our timeslice */
+		/* Park, so other threads can go about their business */
+		SDL_mutexP(SDL_EventLock.state_lock);
 		SDL_EventLock.safe = 1;
+		SDL_CondBroadcast(SDL_EventLock.state_cond);
+		SDL_mutexV(SDL_EventLock.state_lock);
+
 		if ( SDL_timer_running ) {
 			SDL_ThreadedTimerCheck();
 		}
-		SDL_Delay(1);
+		SDL_EventThreadSleep();
 
-		/* Check for event locking.
-		   On the P of the lock mutex, if the lock is held, this thread
-		   will wait until the lock is released before continuing.  The
-		   safe flag will be set, meaning that the other thread can go
-		   about it's business.  The safe flag is reset before the V,
-		   so as soon as the mutex is free, other threads can see that
-		   it's not safe to interfere with the event thread.
+		/* Wait for anyone holding the event thread lock to finish.
+		   The safe flag is reset while the state lock is held, so
+		   as soon as the last holder is done, other threads can see
+		   that it's not safe to interfere with the event thread.
 		 */
-		SDL_mutexP(SDL_EventLock.lock);
+		SDL_mutexP(SDL_EventLock.state_lock);
+		while ( SDL_EventLock.requests ) {
+			SDL_CondWait(SDL_EventLock.state_cond,
+			             SDL_EventLock.state_lock);
+		}
 		SDL_EventLock.safe = 0;
-		SDL_mutexV(SDL_EventLock.lock);
+		SDL_mutexV(SDL_EventLock.state_lock);
 	}
 	SDL_SetTimerThreaded(0);
 	event_thread = 0;
@@ -158,14 +337,32 @@ static int SDL_StartEventThread(Uint32 flags)
 #endif
 	}
 #endif /* !SDL_THREADS_DISABLED */
+#if SDL_EVENT_WAKEUP
+	/* If this fails, SDL_WaitEvent() falls back to polling */
+	if ( SDL_EventWakeup < 0 ) {
+		SDL_EventWakeup = SDL_CreateWakeup();
+	}
+	SDL_EventQ.waiting = 0;
+#endif
 	SDL_EventQ.active = 1;
 
 	if ( (flags&SDL_INIT_EVENTTHREAD) == SDL_INIT_EVENTTHREAD ) {
 		SDL_EventLock.lock = SDL_CreateMutex();
-		if ( SDL_EventLock.lock == NULL ) {
+		SDL_EventLock.state_lock = SDL_CreateMutex();
+		SDL_EventLock.state_cond = SDL_CreateCond();
+		if ( (SDL_EventLock.lock == NULL) ||
+		     (SDL_EventLock.state_lock == NULL) ||
+		     (SDL_EventLock.state_cond == NULL) ) {
 			return(-1);
 		}
 		SDL_EventLock.safe = 0;
+		SDL_EventLock.requests = 0;
+#if SDL_EVENT_WAKEUP
+		/* If this fails, the event thread falls back to polling */
+		if ( SDL_EventThreadWakeup < 0 ) {
+			SDL_EventThreadWakeup = SDL_CreateWakeup();
+		}
+#endif
 
 		/* The event thread will handle timers too */
 		SDL_SetTimerThreaded(2);
@@ -188,15 +385,30 @@ static void SDL_StopEventThread(void)
 {
 	SDL_EventQ.active = 0;
 	if ( SDL_EventThread ) {
+		SDL_WakeEventThread();
 		SDL_WaitThread(SDL_EventThread, NULL);
 		SDL_EventThread = NULL;
+	}
+	if ( SDL_EventLock.lock ) {
 		SDL_DestroyMutex(SDL_EventLock.lock);
 		SDL_EventLock.lock = NULL;
 	}
+	if ( SDL_EventLock.state_lock ) {
+		SDL_DestroyMutex(SDL_EventLock.state_lock);
+		SDL_EventLock.state_lock = NULL;
+	}
+	if ( SDL_EventLock.state_cond ) {
+		SDL_DestroyCond(SDL_EventLock.state_cond);
+		SDL_EventLock.state_cond = NULL;
+	}
 #ifndef IPOD
 	SDL_DestroyMutex(SDL_EventQ.lock);
 	SDL_EventQ.lock = NULL;
 #endif
+#if SDL_EVENT_WAKEUP
+	SDL_CloseWakeup(&SDL_EventThreadWakeup);
+	SDL_CloseWakeup(&SDL_EventWakeup);
+#endif
 }
 
 Uint32 SDL_EventThreadID(void)
@@ -218,21 +430,43 @@ void SDL_StopEventLoop(void)
 	SDL_QuitQuit();
 
 	/* Clean out EventQ */
+	if ( SDL_EventQ.event != SDL_EventQ.static_event ) {
+		SDL_free(SDL_EventQ.event);
+		SDL_free(SDL_EventQ.wmmsg);
+	}
+	SDL_EventQ.event = SDL_EventQ.static_event;
+	SDL_EventQ.wmmsg = SDL_EventQ.static_wmmsg;
+	SDL_EventQ.size = MAXEVENTS;
 	SDL_EventQ.head = 0;
 	SDL_EventQ.tail = 0;
-	SDL_EventQ.wmmsg_next = 0;
+	SDL_EventQ.dead = 0;
 }
 
 /* This function (and associated calls) may be called more than once */
 int SDL_StartEventLoop(Uint32 flags)
 {
 	int retcode;
+	const char *queue_size;
 
 	/* Clean out the event queue */
 	SDL_EventThread = NULL;
 	SDL_EventQ.lock = NULL;
+	SDL_EventQ.event = SDL_EventQ.static_event;
+	SDL_EventQ.wmmsg = SDL_EventQ.static_wmmsg;
 	SDL_StopEventLoop();
 
+	/* The queue grows on demand up to this many events */
+	SDL_EventQ.max_size = MAXQUEUESIZE;
+	queue_size = SDL_getenv("SDL_EVENT_QUEUE_SIZE");
+	if ( queue_size ) {
+		SDL_EventQ.max_size = SDL_atoi(queue_size);
+	}
+	++SDL_EventQ.max_size;	/* One slot is always kept free */
+	if ( SDL_EventQ.max_size < MAXEVENTS ) {
+		SDL_EventQ.max_size = MAXEVENTS;
+	}
+	SDL_EventQ.dropped = 0;
+
 	/* No filter to start with, process most event types */
 	SDL_EventOK = NULL;
 	SDL_memset(SDL_ProcessEvents,SDL_ENABLE,sizeof(SDL_ProcessEvents));
@@ -261,27 +495,98 @@ int SDL_StartEventLoop(Uint32 flags)
 }
 
 
+/* Make room in a full event queue, by dropping cut events or growing it.
+   Returns 0 if there's no room to be had -- called with the queue locked
+ */
+static int SDL_MakeRoom(void)
+{
+	SDL_Event *event;
+	struct SDL_SysWMmsg *wmmsg;
+	int size, here, used;
+
+	if ( SDL_EventQ.dead ) {
+		/* Compact in place, the write spot never passes the read spot */
+		event = SDL_EventQ.event;
+		wmmsg = SDL_EventQ.wmmsg;
+		size = SDL_EventQ.size;
+	} else if ( SDL_EventQ.size < SDL_EventQ.max_size ) {
+		size = SDL_EventQ.size*2;
+		if ( size > SDL_EventQ.max_size ) {
+			size = SDL_EventQ.max_size;
+		}
+		event = (SDL_Event *)SDL_malloc(size*sizeof(*event));
+		wmmsg = (struct SDL_SysWMmsg *)SDL_malloc(size*sizeof(*wmmsg));
+		if ( (event == NULL) || (wmmsg == NULL) ) {
+			if ( event ) {
+				SDL_free(event);
+			}
+			if ( wmmsg ) {
+				SDL_free(wmmsg);
+			}
+			return(0);
+		}
+	} else {
+		return(0);
+	}
+
+	used = (event == SDL_EventQ.event) ? SDL_EventQ.head : 0;
+	for ( here=SDL_EventQ.head; here != SDL_EventQ.tail;
+				here = (here+1)%SDL_EventQ.size ) {
+		if ( SDL_EventQ.event[here].type != SDL_DEADEVENT ) {
+			event[used] = SDL_EventQ.event[here];
+			if ( event[used].type == SDL_SYSWMEVENT ) {
+				/* The message moves along with its event */
+				wmmsg[used] = SDL_EventQ.wmmsg[here];
+				event[used].syswm.msg = &wmmsg[used];
+			}
+			used = (used+1)%size;
+		}
+	}
+
+	if ( event != SDL_EventQ.event ) {
+		if ( SDL_EventQ.event != SDL_EventQ.static_event ) {
+			SDL_free(SDL_EventQ.event);
+			SDL_free(SDL_EventQ.wmmsg);
+		}
+		SDL_EventQ.event = event;
+		SDL_EventQ.wmmsg = wmmsg;
+		SDL_EventQ.size = size;
+		SDL_EventQ.head = 0;
+	}
+	SDL_EventQ.tail = used;
+	SDL_EventQ.dead = 0;
+	return(1);
+}
+
 /* Add an event to the event queue -- called with the queue locked */
 static int SDL_AddEvent(SDL_Event *event)
 {
 	int tail, added;
 
-	tail = (SDL_EventQ.tail+1)%MAXEVENTS;
+	tail = (SDL_EventQ.tail+1)%SDL_EventQ.size;
+	if ( tail == SDL_EventQ.head && SDL_MakeRoom() ) {
+		tail = (SDL_EventQ.tail+1)%SDL_EventQ.size;
+	}
 	if ( tail == SDL_EventQ.head ) {
 		/* Overflow, drop event */
+		++SDL_EventQ.dropped;
 		added = 0;
 	} else {
 		SDL_EventQ.event[SDL_EventQ.tail] = *event;
 		if (event->type == SDL_SYSWMEVENT) {
-			/* Note that it's possible to lose an event */
-			int next = SDL_EventQ.wmmsg_next;
-			SDL_EventQ.wmmsg[next] = *event->syswm.msg;
-		        SDL_EventQ.event[SDL_EventQ.tail].syswm.msg =
-						&SDL_EventQ.wmmsg[next];
-			SDL_EventQ.wmmsg_next = (next+1)%MAXEVENTS;
+			/* The message stays valid until its slot is reused */
+			int spot = SDL_EventQ.tail;
+			SDL_EventQ.wmmsg[spot] = *event->syswm.msg;
+		        SDL_EventQ.event[spot].syswm.msg =
+						&SDL_EventQ.wmmsg[spot];
 		}
 		SDL_EventQ.tail = tail;
 		added = 1;
+#if SDL_EVENT_WAKEUP
+		if ( SDL_EventQ.waiting ) {
+			SDL_SetWakeup(SDL_EventWakeup);
+		}
+#endif
 	}
 	return(added);
 }
@@ -290,27 +595,33 @@ static int SDL_AddEvent(SDL_Event *event)
 /*                           -- called with the queue locked */
 static int SDL_CutEvent(int spot)
 {
+	int size = SDL_EventQ.size;
+
 	if ( spot == SDL_EventQ.head ) {
-		SDL_EventQ.head = (SDL_EventQ.head+1)%MAXEVENTS;
+		/* Move the head past any events cut after this one */
+		SDL_EventQ.head = (SDL_EventQ.head+1)%size;
+		while ( (SDL_EventQ.head != SDL_EventQ.tail) &&
+			(SDL_EventQ.event[SDL_EventQ.head].type == SDL_DEADEVENT) ) {
+			SDL_EventQ.head = (SDL_EventQ.head+1)%size;
+			--SDL_EventQ.dead;
+		}
 		return(SDL_EventQ.head);
 	} else
-	if ( (spot+1)%MAXEVENTS == SDL_EventQ.tail ) {
+	if ( (spot+1)%size == SDL_EventQ.tail ) {
+		/* Move the tail back over any events cut before this one */
 		SDL_EventQ.tail = spot;
+		while ( (SDL_EventQ.tail != SDL_EventQ.head) &&
+			(SDL_EventQ.event[(SDL_EventQ.tail+size-1)%size].type == SDL_DEADEVENT) ) {
+			SDL_EventQ.tail = (SDL_EventQ.tail+size-1)%size;
+			--SDL_EventQ.dead;
+		}
 		return(SDL_EventQ.tail);
 	} else
-	/* We cut the middle -- shift everything over */
+	/* We cut the middle -- leave a dead event to be skipped */
 	{
-		int here, next;
-
-		/* This can probably be optimized with SDL_memcpy() -- careful! */
-		if ( --SDL_EventQ.tail < 0 ) {
-			SDL_EventQ.tail = MAXEVENTS-1;
-		}
-		for ( here=spot; here != SDL_EventQ.tail; here = next ) {
-			next = (here+1)%MAXEVENTS;
-			SDL_EventQ.event[here] = SDL_EventQ.event[next];
-		}
-		return(spot);
+		SDL_EventQ.event[spot].type = SDL_DEADEVENT;
+		++SDL_EventQ.dead;
+		return((spot+1)%size);
 	}
 	/* NOTREACHED */
 }
@@ -344,15 +655,17 @@ int SDL_PeepEvents(SDL_Event *events, int numevents, SDL_eventaction action,
 			}
 			spot = SDL_EventQ.head;
 			while ((used < numevents)&&(spot != SDL_EventQ.tail)) {
-				if ( mask & SDL_EVENTMASK(SDL_EventQ.event[spot].type) ) {
+				Uint8 type = SDL_EventQ.event[spot].type;
+				if ( (type != SDL_DEADEVENT) &&
+				     (mask & SDL_EVENTMASK(type)) ) {
 					events[used++] = SDL_EventQ.event[spot];
 					if ( action == SDL_GETEVENT ) {
 						spot = SDL_CutEvent(spot);
 					} else {
-						spot = (spot+1)%MAXEVENTS;
+						spot = (spot+1)%SDL_EventQ.size;
 					}
 				} else {
-					spot = (spot+1)%MAXEVENTS;
+					spot = (spot+1)%SDL_EventQ.size;
 				}
 			}
 		}
@@ -400,6 +713,58 @@ int SDL_PollEvent (SDL_Event *event)
 	return 1;
 }
 
+/* Sleep until there may be something for SDL_PumpEvents() to pick up */
+static void SDL_WaitForEvents(void)
+{
+#if SDL_EVENT_WAKEUP
+	struct pollfd fds[MAXWAITFDS];
+	int nfds, timeout;
+
+	if ( SDL_EventWakeup < 0 ) {
+		SDL_Delay(10);
+		return;
+	}
+
+	nfds = 0;
+	fds[nfds].fd = SDL_EventWakeup;
+	fds[nfds].events = POLLIN;
+	++nfds;
+	timeout = -1;
+
+	/* The event thread pumps by itself and wakes us up through the queue */
+	if ( !SDL_EventThread ) {
+		nfds = SDL_GetEventSources(fds, nfds, &timeout);
+	}
+	if ( timeout == 0 ) {
+		return;
+	}
+
+	/* Reset the wakeup and make sure nothing slipped in since the peep,
+	   events added from now on will write to it because we're waiting.
+	 */
+	if ( SDL_mutexP(SDL_EventQ.lock) < 0 ) {
+		SDL_Delay(10);
+		return;
+	}
+	SDL_ClearWakeup(SDL_EventWakeup);
+	if ( SDL_EventQ.head != SDL_EventQ.tail ) {
+		SDL_mutexV(SDL_EventQ.lock);
+		return;
+	}
+	++SDL_EventQ.waiting;
+	SDL_mutexV(SDL_EventQ.lock);
+
+	/* Any error, EINTR included, just sends us around the loop again */
+	poll(fds, nfds, timeout);
+
+	SDL_mutexP(SDL_EventQ.lock);
+	--SDL_EventQ.waiting;
+	SDL_mutexV(SDL_EventQ.lock);
+#else
+	SDL_Delay(10);
+#endif /* SDL_EVENT_WAKEUP */
+}
+
 int SDL_WaitEvent (SDL_Event *event)
 {
 	while ( 1 ) {
@@ -407,11 +772,16 @@ int SDL_WaitEvent (SDL_Event *event)
 		switch(SDL_PeepEvents(event, 1, SDL_GETEVENT, SDL_ALLEVENTS)) {
 		    case -1: return 0;
 		    case 1: return 1;
-		    case 0: SDL_Delay(10);
+		    case 0: SDL_WaitForEvents();
 		}
 	}
 }
 
+Uint32 SDL_GetDroppedEvents(void)
+{
+	return(SDL_EventQ.dropped);
+}
+
 int SDL_PushEvent(SDL_Event *event)
 {
 	if ( SDL_PeepEvents(event, 1, SDL_ADDEVENT, 0) <= 0 )
@@ -33,6 +33,9 @@ extern void SDL_Lock_EventThread(void);
 extern void SDL_Unlock_EventThread(void);
 extern Uint32 SDL_EventThreadID(void);
 
+/* Make the event thread recheck its timeouts, e.g. for a new timer */
+extern void SDL_WakeEventThread(void);
+
 /* Event handler init routines */
 extern int  SDL_AppActiveInit(void);
 extern int  SDL_KeyboardInit(void);
@@ -76,6 +79,10 @@ extern void SDL_ResetKeyboard(void);
 /* Used by the event loop to queue pending keyboard repeat events */
 extern void SDL_CheckKeyRepeat(void);
 
+/* Used by the event loop to sleep until the next keyboard repeat event,
+   returns -1 if no key is repeating */
+extern int SDL_KeyRepeatTimeout(void);
+
 /* Used by the OS keyboard code to detect whether or not to do UNICODE */
 #ifndef DEFAULT_UNICODE_TRANSLATION
 #define DEFAULT_UNICODE_TRANSLATION 0	/* Default off because of overhead */
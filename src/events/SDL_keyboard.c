@@ -593,6 +593,25 @@ void SDL_CheckKeyRepeat(void)
 	}
 }
 
+int SDL_KeyRepeatTimeout(void)
+{
+	Uint32 interval, wait;
+
+	if ( ! SDL_KeyRepeat.timestamp ) {
+		return(-1);
+	}
+	interval = (SDL_GetTicks() - SDL_KeyRepeat.timestamp);
+	if ( SDL_KeyRepeat.firsttime ) {
+		wait = (Uint32)SDL_KeyRepeat.delay + 1;
+	} else {
+		wait = (Uint32)SDL_KeyRepeat.interval + 1;
+	}
+	if ( interval >= wait ) {
+		return(0);
+	}
+	return((int)(wait - interval));
+}
+
 int SDL_EnableKeyRepeat(int delay, int interval)
 {
 	if ( (delay < 0) || (interval < 0) ) {
@@ -28,6 +28,14 @@
 #include "SDL_endian.h"
 #include "SDL_rwops.h"
 
+#ifdef HAVE_MMAP
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 
 #if defined(__WIN32__) && !defined(__SYMBIAN32__)
 
@@ -433,6 +441,21 @@ static int SDLCALL mem_close(SDL_RWops *context)
 	return(0);
 }
 
+#ifdef HAVE_MMAP
+/* Functions to read mapped files, these share the memory seek and read */
+static int SDLCALL mmap_close(SDL_RWops *context)
+{
+	if ( context ) {
+		if ( context->hidden.mem.base ) {
+			munmap(context->hidden.mem.base,
+			       context->hidden.mem.stop-context->hidden.mem.base);
+		}
+		SDL_FreeRW(context);
+	}
+	return(0);
+}
+#endif /* HAVE_MMAP */
+
 
 /* Functions to create SDL_RWops structures from various data sources */
 
@@ -580,6 +603,71 @@ SDL_RWops *SDL_RWFromConstMem(const void *mem, int size)
 	return(rwops);
 }
 
+SDL_RWops *SDL_RWFromFileMapped(const char *file)
+{
+#ifdef HAVE_MMAP
+	SDL_RWops *rwops;
+	struct stat st;
+	void *base;
+	int fd;
+
+	if ( !file || !*file ) {
+		SDL_SetError("SDL_RWFromFileMapped(): No file specified");
+		return NULL;
+	}
+	fd = open(file, O_RDONLY);
+	if ( fd < 0 ) {
+		SDL_SetError("Couldn't open %s", file);
+		return NULL;
+	}
+
+	/* Pipes, devices and files too big for an int offset use stdio */
+	if ( (fstat(fd, &st) < 0) || !S_ISREG(st.st_mode) ||
+	     (st.st_size > 0x7FFFFFFF) ) {
+		close(fd);
+		return SDL_RWFromFile(file, "rb");
+	}
+	base = NULL;
+	if ( st.st_size > 0 ) {
+		base = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if ( base == MAP_FAILED ) {
+			close(fd);
+			return SDL_RWFromFile(file, "rb");
+		}
+	}
+	close(fd);	/* The mapping keeps its own reference */
+
+	rwops = SDL_AllocRW();
+	if ( rwops == NULL ) {
+		if ( base ) {
+			munmap(base, (size_t)st.st_size);
+		}
+		return NULL;
+	}
+	rwops->seek = mem_seek;
+	rwops->read = mem_read;
+	rwops->write = mem_writeconst;
+	rwops->close = mmap_close;
+	rwops->hidden.mem.base = (Uint8 *)base;
+	rwops->hidden.mem.here = rwops->hidden.mem.base;
+	rwops->hidden.mem.stop = rwops->hidden.mem.base+(int)st.st_size;
+	return(rwops);
+#else
+	return SDL_RWFromFile(file, "rb");
+#endif /* HAVE_MMAP */
+}
+
+const Uint8 *SDL_RWGetMemory(SDL_RWops *context, int *size)
+{
+	if ( !context || (context->read != mem_read) ) {
+		return NULL;
+	}
+	if ( size ) {
+		*size = (int)(context->hidden.mem.stop-context->hidden.mem.here);
+	}
+	return context->hidden.mem.here;
+}
+
 SDL_RWops *SDL_AllocRW(void)
 {
 	SDL_RWops *area;
@@ -574,6 +574,24 @@ void SDL_JoystickUpdate(void)
 	}
 }
 
+int SDL_JoystickGetFDs(int *fds, int maxfds)
+{
+	int i, numfds;
+
+	numfds = 0;
+	for ( i=0; SDL_joysticks[i]; ++i ) {
+#if SDL_JOYSTICK_LINUX
+		int fd = SDL_SYS_JoystickGetFD(SDL_joysticks[i]);
+		if ( (fd >= 0) && (numfds < maxfds) ) {
+			fds[numfds++] = fd;
+			continue;
+		}
+#endif
+		return(-1);
+	}
+	return(numfds);
+}
+
 int SDL_JoystickEventState(int state)
 {
 #if SDL_EVENTS_DISABLED
@@ -74,6 +74,13 @@ extern int SDL_SYS_JoystickOpen(SDL_Joystick *joystick);
  */
 extern void SDL_SYS_JoystickUpdate(SDL_Joystick *joystick);
 
+#if SDL_JOYSTICK_LINUX
+/* Function to get a file descriptor that becomes readable when the joystick
+   has new input, or -1 if it has to be polled.
+ */
+extern int SDL_SYS_JoystickGetFD(SDL_Joystick *joystick);
+#endif
+
 /* Function to close a joystick after use */
 extern void SDL_SYS_JoystickClose(SDL_Joystick *joystick);
 
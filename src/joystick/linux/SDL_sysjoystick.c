@@ -1177,6 +1177,12 @@ void SDL_SYS_JoystickUpdate(SDL_Joystick *joystick)
 	}
 }
 
+int SDL_SYS_JoystickGetFD(SDL_Joystick *joystick)
+{
+	/* Logical joysticks share the descriptor of the real device */
+	return(joystick->hwdata->fd);
+}
+
 /* Function to close a joystick after use */
 void SDL_SYS_JoystickClose(SDL_Joystick *joystick)
 {
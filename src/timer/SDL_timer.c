@@ -25,6 +25,9 @@
 #include "SDL_timer_c.h"
 #include "SDL_mutex.h"
 #include "SDL_systimer.h"
+#if !SDL_EVENTS_DISABLED
+#include "../events/SDL_events_c.h"
+#endif
 
 /* #define DEBUG_TIMERS */
 
@@ -43,12 +46,32 @@ struct _SDL_TimerID {
 	SDL_NewTimerCallback cb;
 	void *param;
 	Uint32 last_alarm;
-	struct _SDL_TimerID *next;
+	int index;		/* Position in SDL_timers, or -1 */
+	SDL_TimerID next;	/* The next released timer */
 };
 
-static SDL_TimerID SDL_timers = NULL;
+/* The timers are kept in a binary min-heap ordered by their next alarm,
+   so the next deadline is always SDL_timers[0].  Each timer knows its
+   position in the heap, so it can be removed in O(log n).
+ */
+static SDL_TimerID *SDL_timers = NULL;
+static int SDL_numtimers = 0;
+static int SDL_maxtimers = 0;
+
+/* Released timers are kept until SDL_TimerQuit(), so a stale id still
+   points at a timer, one that is out of the heap or has been reused.
+ */
+static SDL_TimerID SDL_freetimers = NULL;
 static SDL_mutex *SDL_timer_mutex;
-static volatile SDL_bool list_changed = SDL_FALSE;
+static SDL_cond *SDL_timer_cond;
+static int SDL_timer_wakeup = 0;
+
+/* The timer whose callback is running, it's out of the heap meanwhile */
+static SDL_TimerID SDL_timer_current = NULL;
+static SDL_bool SDL_timer_current_removed = SDL_FALSE;
+
+#define TIMER_DEADLINE(t)	((t)->last_alarm + (t)->interval)
+#define TIMER_BEFORE(a, b)	((Sint32)(TIMER_DEADLINE(a) - TIMER_DEADLINE(b)) < 0)
 
 /* Set whether or not the timer should use a thread.
    This should not be called while the timer subsystem is running.
@@ -80,6 +103,7 @@ int SDL_TimerInit(void)
 	}
 	if ( SDL_timer_threaded ) {
 		SDL_timer_mutex = SDL_CreateMutex();
+		SDL_timer_cond = SDL_CreateCond();
 	}
 	if ( retval == 0 ) {
 		SDL_timer_started = 1;
@@ -94,87 +118,251 @@ void SDL_TimerQuit(void)
 		SDL_SYS_TimerQuit();
 	}
 	if ( SDL_timer_threaded ) {
+		SDL_DestroyCond(SDL_timer_cond);
+		SDL_timer_cond = NULL;
 		SDL_DestroyMutex(SDL_timer_mutex);
 		SDL_timer_mutex = NULL;
 	}
+	if ( SDL_timers ) {
+		SDL_free(SDL_timers);
+		SDL_timers = NULL;
+		SDL_maxtimers = 0;
+	}
+	while ( SDL_freetimers ) {
+		SDL_TimerID t = SDL_freetimers;
+		SDL_freetimers = t->next;
+		SDL_free(t);
+	}
 	SDL_timer_started = 0;
 	SDL_timer_threaded = 0;
 }
 
+/* Heap maintenance -- called with the timer mutex held */
+static void SDL_SiftUp(int i)
+{
+	SDL_TimerID t = SDL_timers[i];
+
+	while ( i > 0 ) {
+		int parent = (i-1)/2;
+		if ( ! TIMER_BEFORE(t, SDL_timers[parent]) ) {
+			break;
+		}
+		SDL_timers[i] = SDL_timers[parent];
+		SDL_timers[i]->index = i;
+		i = parent;
+	}
+	SDL_timers[i] = t;
+	t->index = i;
+}
+
+static void SDL_SiftDown(int i)
+{
+	SDL_TimerID t = SDL_timers[i];
+
+	for ( ;; ) {
+		int child = 2*i+1;
+		if ( child >= SDL_numtimers ) {
+			break;
+		}
+		if ( (child+1 < SDL_numtimers) &&
+		     TIMER_BEFORE(SDL_timers[child+1], SDL_timers[child]) ) {
+			++child;
+		}
+		if ( ! TIMER_BEFORE(SDL_timers[child], t) ) {
+			break;
+		}
+		SDL_timers[i] = SDL_timers[child];
+		SDL_timers[i]->index = i;
+		i = child;
+	}
+	SDL_timers[i] = t;
+	t->index = i;
+}
+
+static int SDL_HeapInsert(SDL_TimerID t)
+{
+	if ( SDL_numtimers == SDL_maxtimers ) {
+		int maxtimers = SDL_maxtimers ? SDL_maxtimers*2 : 16;
+		SDL_TimerID *timers;
+
+		timers = (SDL_TimerID *)SDL_realloc(SDL_timers,
+		                                 maxtimers*sizeof(*timers));
+		if ( timers == NULL ) {
+			SDL_OutOfMemory();
+			return(-1);
+		}
+		SDL_timers = timers;
+		SDL_maxtimers = maxtimers;
+	}
+	SDL_timers[SDL_numtimers] = t;
+	SDL_SiftUp(SDL_numtimers++);
+	return(0);
+}
+
+static void SDL_HeapRemove(int i)
+{
+	SDL_timers[i]->index = -1;
+	--SDL_numtimers;
+	if ( i < SDL_numtimers ) {
+		SDL_TimerID last = SDL_timers[SDL_numtimers];
+		SDL_timers[i] = last;
+		if ( (i > 0) && TIMER_BEFORE(last, SDL_timers[(i-1)/2]) ) {
+			SDL_SiftUp(i);
+		} else {
+			SDL_SiftDown(i);
+		}
+	}
+}
+
+/* Get a timer, reusing a released one if there is one */
+static SDL_TimerID SDL_NewTimer(void)
+{
+	SDL_TimerID t = SDL_freetimers;
+
+	if ( t ) {
+		SDL_freetimers = t->next;
+	} else {
+		t = (SDL_TimerID) SDL_malloc(sizeof(struct _SDL_TimerID));
+	}
+	return t;
+}
+
+static void SDL_ReleaseTimer(SDL_TimerID t)
+{
+	t->index = -1;
+	t->next = SDL_freetimers;
+	SDL_freetimers = t;
+}
+
+/* Milliseconds until the first deadline -- called with the mutex held */
+static int SDL_NextTimeout(void)
+{
+	Sint32 remaining;
+
+	if ( ! SDL_numtimers ) {
+		return(-1);
+	}
+	remaining = (Sint32)(TIMER_DEADLINE(SDL_timers[0]) - SDL_GetTicks());
+	return((remaining > 0) ? (int)remaining : 0);
+}
+
 void SDL_ThreadedTimerCheck(void)
 {
 	Uint32 now, ms;
-	SDL_TimerID t, prev, next;
-	SDL_bool removed;
+	SDL_TimerID t;
 
 	SDL_mutexP(SDL_timer_mutex);
-	list_changed = SDL_FALSE;
 	now = SDL_GetTicks();
-	for ( prev = NULL, t = SDL_timers; t; t = next ) {
-		removed = SDL_FALSE;
-		ms = t->interval - SDL_TIMESLICE;
-		next = t->next;
-		if ( (int)(now - t->last_alarm) > (int)ms ) {
-			struct _SDL_TimerID timer;
-
-			if ( (now - t->last_alarm) < t->interval ) {
-				t->last_alarm += t->interval;
-			} else {
-				t->last_alarm = now;
-			}
+	while ( SDL_numtimers ) {
+		t = SDL_timers[0];
+		if ( (Sint32)(now - TIMER_DEADLINE(t)) < 0 ) {
+			break;
+		}
+		SDL_HeapRemove(0);
+
+		/* Keep the cadence unless we've fallen a whole interval behind */
+		if ( (now - t->last_alarm) < 2*t->interval ) {
+			t->last_alarm += t->interval;
+		} else {
+			t->last_alarm = now;
+		}
 #ifdef DEBUG_TIMERS
-			printf("Executing timer %p (thread = %d)\n",
-				t, SDL_ThreadID());
+		printf("Executing timer %p (thread = %d)\n",
+			t, SDL_ThreadID());
 #endif
-			timer = *t;
-			SDL_mutexV(SDL_timer_mutex);
-			ms = timer.cb(timer.interval, timer.param);
-			SDL_mutexP(SDL_timer_mutex);
-			if ( list_changed ) {
-				/* Abort, list of timers modified */
-				/* FIXME: what if ms was changed? */
-				break;
+		SDL_timer_current = t;
+		SDL_timer_current_removed = SDL_FALSE;
+		SDL_mutexV(SDL_timer_mutex);
+		ms = t->cb(t->interval, t->param);
+		SDL_mutexP(SDL_timer_mutex);
+		SDL_timer_current = NULL;
+
+		if ( ! SDL_timer_current_removed ) {
+			if ( ms ) {
+				t->interval = ms;
+				if ( SDL_HeapInsert(t) == 0 ) {
+					continue;
+				}
 			}
-			if ( ms != t->interval ) {
-				if ( ms ) {
-					t->interval = ROUND_RESOLUTION(ms);
-				} else {
-					/* Remove timer from the list */
+			/* Remove timer from the list */
 #ifdef DEBUG_TIMERS
-					printf("SDL: Removing timer %p\n", t);
+			printf("SDL: Removing timer %p\n", t);
 #endif
-					if ( prev ) {
-						prev->next = next;
-					} else {
-						SDL_timers = next;
-					}
-					SDL_free(t);
-					--SDL_timer_running;
-					removed = SDL_TRUE;
-				}
-			}
+			--SDL_timer_running;
 		}
-		/* Don't update prev if the timer has disappeared */
-		if ( ! removed ) {
-			prev = t;
+		SDL_ReleaseTimer(t);
+	}
+	SDL_mutexV(SDL_timer_mutex);
+}
+
+int SDL_ThreadedTimerTimeout(void)
+{
+	int timeout;
+
+	SDL_mutexP(SDL_timer_mutex);
+	timeout = SDL_NextTimeout();
+	SDL_mutexV(SDL_timer_mutex);
+	return(timeout);
+}
+
+void SDL_ThreadedTimerSleep(void)
+{
+	int timeout;
+
+	/* The mutex only exists once SDL_SYS_TimerInit() has returned */
+	if ( ! SDL_timer_mutex ) {
+		SDL_Delay(1);
+		return;
+	}
+	SDL_mutexP(SDL_timer_mutex);
+	if ( ! SDL_timer_wakeup ) {
+		timeout = SDL_NextTimeout();
+		if ( timeout < 0 ) {
+			SDL_CondWait(SDL_timer_cond, SDL_timer_mutex);
+		} else if ( timeout > 0 ) {
+			SDL_CondWaitTimeout(SDL_timer_cond, SDL_timer_mutex,
+			                    (Uint32)timeout);
 		}
 	}
+	SDL_timer_wakeup = 0;
 	SDL_mutexV(SDL_timer_mutex);
 }
 
+void SDL_ThreadedTimerWakeup(void)
+{
+	if ( SDL_timer_mutex ) {
+		SDL_mutexP(SDL_timer_mutex);
+		SDL_timer_wakeup = 1;
+		SDL_CondSignal(SDL_timer_cond);
+		SDL_mutexV(SDL_timer_mutex);
+	}
+}
+
 static SDL_TimerID SDL_AddTimerInternal(Uint32 interval, SDL_NewTimerCallback callback, void *param)
 {
 	SDL_TimerID t;
-	t = (SDL_TimerID) SDL_malloc(sizeof(struct _SDL_TimerID));
+	t = SDL_NewTimer();
 	if ( t ) {
-		t->interval = ROUND_RESOLUTION(interval);
+		/* A zero interval would keep the timer due forever */
+		t->interval = interval ? interval : 1;
 		t->cb = callback;
 		t->param = param;
 		t->last_alarm = SDL_GetTicks();
-		t->next = SDL_timers;
-		SDL_timers = t;
+		if ( SDL_HeapInsert(t) < 0 ) {
+			SDL_ReleaseTimer(t);
+			return NULL;
+		}
 		++SDL_timer_running;
-		list_changed = SDL_TRUE;
+
+		/* The timer thread may be asleep until a later deadline */
+		if ( SDL_timer_cond ) {
+			SDL_CondSignal(SDL_timer_cond);
+		}
+#if !SDL_EVENTS_DISABLED
+		if ( SDL_timer_threaded == 2 ) {
+			SDL_WakeEventThread();
+		}
+#endif
 	}
 #ifdef DEBUG_TIMERS
 	printf("SDL_AddTimer(%d) = %08x num_timers = %d\n", interval, (Uint32)t, SDL_timer_running);
@@ -205,25 +393,24 @@ SDL_TimerID SDL_AddTimer(Uint32 interval, SDL_NewTimerCallback callback, void *p
 
 SDL_bool SDL_RemoveTimer(SDL_TimerID id)
 {
-	SDL_TimerID t, prev = NULL;
 	SDL_bool removed;
 
 	removed = SDL_FALSE;
 	SDL_mutexP(SDL_timer_mutex);
-	/* Look for id in the linked list of timers */
-	for (t = SDL_timers; t; prev=t, t = t->next ) {
-		if ( t == id ) {
-			if(prev) {
-				prev->next = t->next;
-			} else {
-				SDL_timers = t->next;
-			}
-			SDL_free(t);
+	if ( id && (id == SDL_timer_current) ) {
+		/* Freed when its callback returns */
+		if ( ! SDL_timer_current_removed ) {
+			SDL_timer_current_removed = SDL_TRUE;
 			--SDL_timer_running;
 			removed = SDL_TRUE;
-			list_changed = SDL_TRUE;
-			break;
 		}
+	} else if ( id && (id->index >= 0) && (id->index < SDL_numtimers) &&
+	            (SDL_timers[id->index] == id) ) {
+		/* A stale id is never in the heap, so it isn't removed */
+		SDL_HeapRemove(id->index);
+		SDL_ReleaseTimer(id);
+		--SDL_timer_running;
+		removed = SDL_TRUE;
 	}
 #ifdef DEBUG_TIMERS
 	printf("SDL_RemoveTimer(%08x) = %d num_timers = %d thread = %d\n", (Uint32)id, removed, SDL_timer_running, SDL_ThreadID());
@@ -232,6 +419,35 @@ SDL_bool SDL_RemoveTimer(SDL_TimerID id)
 	return removed;
 }
 
+#if !SDL_TIMER_UNIX
+/* Platforms without a finer clock count in milliseconds */
+Uint64 SDL_GetPerformanceCounter(void)
+{
+	return(SDL_GetTicks());
+}
+
+Uint64 SDL_GetPerformanceFrequency(void)
+{
+	return(1000);
+}
+
+void SDL_DelayNS(Uint64 ns)
+{
+	Uint32 ms = (Uint32)(ns/1000000);
+
+	/* Sleep all but the last millisecond, and spin that off */
+	if ( ms > 1 ) {
+		Uint32 then = SDL_GetTicks() + ms;
+		SDL_Delay(ms-1);
+		while ( (Sint32)(SDL_GetTicks() - then) < 0 ) {
+			;
+		}
+	} else if ( ms ) {
+		SDL_Delay(ms);
+	}
+}
+#endif /* !SDL_TIMER_UNIX */
+
 /* Old style callback functions are wrapped through this */
 static Uint32 SDLCALL callback_wrapper(Uint32 ms, void *param)
 {
@@ -253,13 +469,13 @@ int SDL_SetTimer(Uint32 ms, SDL_TimerCallback callback)
 	}
 	if ( SDL_timer_running ) {	/* Stop any currently running timer */
 		if ( SDL_timer_threaded ) {
-			while ( SDL_timers ) {
-				SDL_TimerID freeme = SDL_timers;
-				SDL_timers = SDL_timers->next;
-				SDL_free(freeme);
+			while ( SDL_numtimers ) {
+				SDL_ReleaseTimer(SDL_timers[--SDL_numtimers]);
+			}
+			if ( SDL_timer_current ) {
+				SDL_timer_current_removed = SDL_TRUE;
 			}
 			SDL_timer_running = 0;
-			list_changed = SDL_TRUE;
 		} else {
 			SDL_SYS_StopTimer();
 			SDL_timer_running = 0;
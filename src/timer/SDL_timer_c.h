@@ -44,3 +44,11 @@ extern void SDL_TimerQuit(void);
 
 /* This function is called from the SDL event thread if it is available */
 extern void SDL_ThreadedTimerCheck(void);
+
+/* Milliseconds until SDL_ThreadedTimerCheck() has work, or -1 if never */
+extern int SDL_ThreadedTimerTimeout(void);
+
+/* Used by a timer thread to sleep until the next deadline, a new timer
+   or SDL_ThreadedTimerWakeup(), whichever comes first */
+extern void SDL_ThreadedTimerSleep(void);
+extern void SDL_ThreadedTimerWakeup(void);
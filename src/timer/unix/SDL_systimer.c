@@ -38,8 +38,13 @@
    for __USE_POSIX199309
    Tommi Kyntola (tommi.kyntola@ray.fi) 27/09/2005
 */
-#if HAVE_NANOSLEEP || HAVE_CLOCK_GETTIME
 #include <time.h>
+
+/* The performance counter must never go backwards, so it uses the
+   monotonic clock wherever there is one, even when the ticks don't
+   (see --enable-clock_gettime) */
+#if HAVE_CLOCK_GETTIME || defined(CLOCK_MONOTONIC)
+#define USE_MONOTONIC_COUNTER
 #endif
 
 #if SDL_THREAD_PTH
@@ -85,6 +90,73 @@ Uint32 SDL_GetTicks (void)
 #endif
 }
 
+Uint64 SDL_GetPerformanceCounter(void)
+{
+#ifdef USE_MONOTONIC_COUNTER
+	struct timespec now;
+	clock_gettime(CLOCK_MONOTONIC,&now);
+	return((Uint64)now.tv_sec*1000000000 + now.tv_nsec);
+#else
+	struct timeval now;
+	gettimeofday(&now, NULL);
+	return((Uint64)now.tv_sec*1000000 + now.tv_usec);
+#endif
+}
+
+Uint64 SDL_GetPerformanceFrequency(void)
+{
+#ifdef USE_MONOTONIC_COUNTER
+	return(1000000000);
+#else
+	return(1000000);
+#endif
+}
+
+/* Wake up this long before the deadline of SDL_DelayNS() and spin the rest,
+   the scheduler rarely gets us back on the CPU much quicker than this */
+#define DELAY_SPIN_NS	200000
+
+void SDL_DelayNS(Uint64 ns)
+{
+	Uint64 now, then, left;
+#if HAVE_NANOSLEEP
+	struct timespec tv;
+#endif
+
+	now = SDL_GetPerformanceCounter();
+#ifdef USE_MONOTONIC_COUNTER
+	then = now + ns;
+#else
+	then = now + ns/1000;
+#endif
+	for ( ;; ) {
+		now = SDL_GetPerformanceCounter();
+		if ( now >= then ) {
+			break;
+		}
+#ifdef USE_MONOTONIC_COUNTER
+		left = then - now;
+#else
+		left = (then - now)*1000;
+#endif
+		if ( left <= DELAY_SPIN_NS ) {
+			continue;
+		}
+		left -= DELAY_SPIN_NS;
+#if SDL_THREAD_PTH || !HAVE_NANOSLEEP
+		if ( left < 1000000 ) {
+			continue;
+		}
+		SDL_Delay((Uint32)(left/1000000));
+#else
+		/* An interrupted sleep just goes around again */
+		tv.tv_sec = (time_t)(left/1000000000);
+		tv.tv_nsec = (long)(left%1000000000);
+		nanosleep(&tv, NULL);
+#endif
+	}
+}
+
 void SDL_Delay (Uint32 ms)
 {
 #if SDL_THREAD_PTH
@@ -200,7 +272,7 @@ static int RunTimer(void *unused)
 		if ( SDL_timer_running ) {
 			SDL_ThreadedTimerCheck();
 		}
-		SDL_Delay(1);
+		SDL_ThreadedTimerSleep();
 	}
 	return(0);
 }
@@ -219,6 +291,7 @@ void SDL_SYS_TimerQuit(void)
 {
 	timer_alive = 0;
 	if ( timer ) {
+		SDL_ThreadedTimerWakeup();
 		SDL_WaitThread(timer, NULL);
 		timer = NULL;
 	}
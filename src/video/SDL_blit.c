@@ -22,6 +22,7 @@
 #include "SDL_config.h"
 
 #include "SDL_video.h"
+#include "SDL_thread.h"
 #include "SDL_sysvideo.h"
 #include "SDL_blit.h"
 #include "SDL_RLEaccel_c.h"
@@ -39,14 +40,221 @@
 #include "mmx.h"
 #endif
 
+/* A pool of threads that large software blits are split across, by rows */
+typedef struct SDL_BlitWorker {
+	SDL_Thread *thread;
+	SDL_sem *start;
+	SDL_BlitInfo info;	/* This worker's band of the blit */
+} SDL_BlitWorker;
+
+static struct {
+	int num_workers;	/* The calling thread runs a band too */
+	int min_area;		/* Smaller blits aren't worth splitting */
+	SDL_BlitWorker *workers;
+	SDL_sem *done;
+	SDL_sem *idle;		/* Taken while a blit is using the pool */
+	SDL_loblit blit;
+	int quit;
+} SDL_blit_pool;
+
+/* Bands shorter than this cost more to hand out than they save */
+#define BLIT_BAND_MIN_ROWS	16
+
+static int SDLCALL SDL_BlitThread(void *data)
+{
+	SDL_BlitWorker *worker = (SDL_BlitWorker *)data;
+
+	for ( ; ; ) {
+		SDL_SemWait(worker->start);
+		if ( SDL_blit_pool.quit ) {
+			break;
+		}
+		SDL_blit_pool.blit(&worker->info);
+		SDL_SemPost(SDL_blit_pool.done);
+	}
+	return(0);
+}
+
+/*
+ * Start the blit threads if SDL_BLIT_THREADS asks for more than one.
+ * SDL_BLIT_THREAD_AREA is the smallest blit, in pixels, that is split.
+ */
+void SDL_BlitThreadsInit(void)
+{
+	const char *env;
+	int i, num_threads;
+
+	env = SDL_getenv("SDL_BLIT_THREADS");
+	num_threads = env ? SDL_atoi(env) : 0;
+	if ( num_threads < 2 ) {
+		return;
+	}
+	if ( num_threads > 64 ) {
+		num_threads = 64;
+	}
+	env = SDL_getenv("SDL_BLIT_THREAD_AREA");
+	SDL_blit_pool.min_area = env ? SDL_atoi(env) : 256*256;
+
+	SDL_blit_pool.quit = 0;
+	SDL_blit_pool.workers = (SDL_BlitWorker *)
+			SDL_calloc(num_threads-1, sizeof(SDL_BlitWorker));
+	SDL_blit_pool.done = SDL_CreateSemaphore(0);
+	SDL_blit_pool.idle = SDL_CreateSemaphore(1);
+	if ( !SDL_blit_pool.workers ||
+	     !SDL_blit_pool.done || !SDL_blit_pool.idle ) {
+		SDL_BlitThreadsQuit();
+		return;
+	}
+	for ( i = 0; i < num_threads-1; ++i ) {
+		SDL_BlitWorker *worker = &SDL_blit_pool.workers[i];
+
+		worker->start = SDL_CreateSemaphore(0);
+		if ( !worker->start ) {
+			break;
+		}
+		worker->thread = SDL_CreateThread(SDL_BlitThread, worker);
+		if ( !worker->thread ) {
+			SDL_DestroySemaphore(worker->start);
+			break;
+		}
+		++SDL_blit_pool.num_workers;
+	}
+	if ( SDL_blit_pool.num_workers == 0 ) {
+		SDL_BlitThreadsQuit();
+	}
+}
+
+void SDL_BlitThreadsQuit(void)
+{
+	int i;
+
+	SDL_blit_pool.quit = 1;
+	for ( i = 0; i < SDL_blit_pool.num_workers; ++i ) {
+		SDL_SemPost(SDL_blit_pool.workers[i].start);
+		SDL_WaitThread(SDL_blit_pool.workers[i].thread, NULL);
+		SDL_DestroySemaphore(SDL_blit_pool.workers[i].start);
+	}
+	SDL_blit_pool.num_workers = 0;
+	if ( SDL_blit_pool.done ) {
+		SDL_DestroySemaphore(SDL_blit_pool.done);
+		SDL_blit_pool.done = NULL;
+	}
+	if ( SDL_blit_pool.idle ) {
+		SDL_DestroySemaphore(SDL_blit_pool.idle);
+		SDL_blit_pool.idle = NULL;
+	}
+	if ( SDL_blit_pool.workers ) {
+		SDL_free(SDL_blit_pool.workers);
+		SDL_blit_pool.workers = NULL;
+	}
+}
+
+/* Split a blit into bands of rows, run them in parallel and wait for them */
+static void SDL_RunBlitBands(SDL_loblit RunBlit, SDL_BlitInfo *info,
+				int s_pitch, int d_pitch)
+{
+	int i, bands, height, top, bottom;
+
+	height = info->d_height;
+	bands = height / BLIT_BAND_MIN_ROWS;
+	if ( bands > SDL_blit_pool.num_workers+1 ) {
+		bands = SDL_blit_pool.num_workers+1;
+	}
+
+	/* Band edges are spread evenly, so no band is ever empty */
+	SDL_blit_pool.blit = RunBlit;
+	for ( i = 1; i < bands; ++i ) {
+		SDL_BlitInfo *band = &SDL_blit_pool.workers[i-1].info;
+
+		top = i*height/bands;
+		bottom = (i+1)*height/bands;
+		*band = *info;
+		band->s_pixels += top*s_pitch;
+		band->d_pixels += top*d_pitch;
+		band->s_height = band->d_height = bottom-top;
+		SDL_SemPost(SDL_blit_pool.workers[i-1].start);
+	}
+	info->s_height = info->d_height = height/bands;
+	RunBlit(info);
+	for ( i = 1; i < bands; ++i ) {
+		SDL_SemWait(SDL_blit_pool.done);
+	}
+}
+
+/* Run the chosen software blitter over one rectangle of locked surfaces */
+static void SDL_RunSoftBlit(SDL_Surface *src, SDL_Rect *srcrect,
+			SDL_Surface *dst, SDL_Rect *dstrect)
+{
+	SDL_BlitInfo info;
+	SDL_loblit RunBlit;
+
+	/* Set up the blit information */
+	info.s_pixels = (Uint8 *)src->pixels +
+			(Uint16)srcrect->y*src->pitch +
+			(Uint16)srcrect->x*src->format->BytesPerPixel;
+	info.s_width = srcrect->w;
+	info.s_height = srcrect->h;
+	info.s_skip=src->pitch-info.s_width*src->format->BytesPerPixel;
+	info.d_pixels = (Uint8 *)dst->pixels +
+			(Uint16)dstrect->y*dst->pitch +
+			(Uint16)dstrect->x*dst->format->BytesPerPixel;
+	info.d_width = dstrect->w;
+	info.d_height = dstrect->h;
+	info.d_skip=dst->pitch-info.d_width*dst->format->BytesPerPixel;
+	info.aux_data = src->map->sw_data->aux_data;
+	info.src = src->format;
+	info.table = src->map->table;
+	info.dst = dst->format;
+	RunBlit = src->map->sw_data->blit;
+
+	/* Large blits are split across the blit threads, unless the rows
+	   overlap or another thread is already using them.
+	 */
+	if ( SDL_blit_pool.num_workers &&
+	     (info.d_width*info.d_height >= SDL_blit_pool.min_area) &&
+	     (info.d_height >= 2*BLIT_BAND_MIN_ROWS) &&
+	     (src->pixels != dst->pixels) &&
+	     (SDL_SemTryWait(SDL_blit_pool.idle) == 0) ) {
+		SDL_RunBlitBands(RunBlit, &info, src->pitch, dst->pitch);
+		SDL_SemPost(SDL_blit_pool.idle);
+		return;
+	}
+
+	/* Run the actual software blit */
+	RunBlit(&info);
+}
+
 /* The general purpose software blit routine */
 static int SDL_SoftBlit(SDL_Surface *src, SDL_Rect *srcrect,
 			SDL_Surface *dst, SDL_Rect *dstrect)
 {
+	SDL_Rect rects[2];
+
+	rects[0] = *srcrect;
+	rects[1] = *dstrect;
+	return(SDL_SoftBlitBatch(src, dst, rects, 1));
+}
+
+/* Blit many clipped rectangles with a single lock of each surface */
+int SDL_SoftBlitBatch(SDL_Surface *src, SDL_Surface *dst,
+			SDL_Rect *rects, int n)
+{
+	int i;
 	int okay;
 	int src_locked;
 	int dst_locked;
 
+	/* RLE blitters take care of their own locking */
+	if ( src->map->sw_blit != SDL_SoftBlit ) {
+		for ( i = 0; i < n; ++i ) {
+			if ( src->map->sw_blit(src, &rects[2*i],
+			                       dst, &rects[2*i+1]) < 0 ) {
+				return(-1);
+			}
+		}
+		return(0);
+	}
+
 	/* Everything is okay at the beginning...  */
 	okay = 1;
 
@@ -70,31 +278,13 @@ static int SDL_SoftBlit(SDL_Surface *src, SDL_Rect *srcrect,
 	}
 
 	/* Set up source and destination buffer pointers, and BLIT! */
-	if ( okay  && srcrect->w && srcrect->h ) {
-		SDL_BlitInfo info;
-		SDL_loblit RunBlit;
-
-		/* Set up the blit information */
-		info.s_pixels = (Uint8 *)src->pixels +
-				(Uint16)srcrect->y*src->pitch +
-				(Uint16)srcrect->x*src->format->BytesPerPixel;
-		info.s_width = srcrect->w;
-		info.s_height = srcrect->h;
-		info.s_skip=src->pitch-info.s_width*src->format->BytesPerPixel;
-		info.d_pixels = (Uint8 *)dst->pixels +
-				(Uint16)dstrect->y*dst->pitch +
-				(Uint16)dstrect->x*dst->format->BytesPerPixel;
-		info.d_width = dstrect->w;
-		info.d_height = dstrect->h;
-		info.d_skip=dst->pitch-info.d_width*dst->format->BytesPerPixel;
-		info.aux_data = src->map->sw_data->aux_data;
-		info.src = src->format;
-		info.table = src->map->table;
-		info.dst = dst->format;
-		RunBlit = src->map->sw_data->blit;
-
-		/* Run the actual software blit */
-		RunBlit(&info);
+	if ( okay ) {
+		for ( i = 0; i < n; ++i ) {
+			if ( rects[2*i].w && rects[2*i].h ) {
+				SDL_RunSoftBlit(src, &rects[2*i],
+				                dst, &rects[2*i+1]);
+			}
+		}
 	}
 
 	/* We need to unlock the surfaces if they're locked */
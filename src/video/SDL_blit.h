@@ -69,6 +69,11 @@ typedef struct SDL_BlitMap {
 
 /* Functions found in SDL_blit.c */
 extern int SDL_CalculateBlit(SDL_Surface *surface);
+extern void SDL_BlitThreadsInit(void);
+extern void SDL_BlitThreadsQuit(void);
+/* 'rects' holds n source and destination rectangle pairs, already clipped */
+extern int SDL_SoftBlitBatch(SDL_Surface *src, SDL_Surface *dst,
+			SDL_Rect *rects, int n);
 
 /* Functions found in SDL_blit_{0,1,N,A}.c */
 extern SDL_loblit SDL_CalculateBlit0(SDL_Surface *surface, int complex);
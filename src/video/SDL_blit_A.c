@@ -51,6 +51,12 @@
 #  endif
 #endif /* SDL_ASSEMBLY_ROUTINES */
 
+/* SSE2 is always there on x86-64, and any x86 build that enables it */
+#if SDL_ASSEMBLY_ROUTINES && \
+    (defined(__SSE2__) || (defined(_MSC_VER) && defined(_M_X64)))
+#define SSE2_ASMBLIT 1
+#endif
+
 /* Function to check the CPU flags */
 #include "SDL_cpuinfo.h"
 #if GCC_ASMBLIT
@@ -59,6 +65,9 @@
 #include <mmintrin.h>
 #include <mm3dnow.h>
 #endif
+#if SSE2_ASMBLIT
+#include <emmintrin.h>
+#endif
 
 /* Functions to perform alpha blended blitting */
 
@@ -2720,6 +2729,599 @@ static void BlitNtoNPixelAlpha(SDL_BlitInfo *info)
 }
 
 
+#if SSE2_ASMBLIT
+/*
+ * The SSE2 blitters work on four pixels at a time, and give exactly the
+ * same results as the C blitters above, down to the rounding of their
+ * packed arithmetic.  The one exception is that the unsigned ALPHA_BLEND()
+ * in the N->N blitters can carry a stray bit into bit 24 of the pixel,
+ * which isn't reproduced.  The last pixels of a row go through a small
+ * buffer so that they are blended the same way.
+ */
+
+/* The low 32 bits of a*b in each lane, with b < 0x10000 in both halves */
+static __inline__ __m128i SDL_mul32_sse2(__m128i a, __m128i b)
+{
+	return _mm_add_epi32(_mm_mullo_epi16(a, b),
+			     _mm_slli_epi32(_mm_mulhi_epu16(a, b), 16));
+}
+
+/* (mask & a) | (~mask & b) */
+static __inline__ __m128i SDL_select_sse2(__m128i mask, __m128i a, __m128i b)
+{
+	return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+/* d + ((s - d) * alpha >> 8) on the channels picked by 'mask', as in
+   the C blitters; 'alpha' is in both halves of each lane */
+static __inline__ __m128i SDL_blend32_sse2(__m128i s, __m128i d,
+					   __m128i alpha, __m128i mask)
+{
+	s = _mm_and_si128(s, mask);
+	d = _mm_and_si128(d, mask);
+	d = _mm_add_epi32(d, _mm_srli_epi32(
+		SDL_mul32_sse2(_mm_sub_epi32(s, d), alpha), 8));
+	return _mm_and_si128(d, mask);
+}
+
+/* Four pixels of BlitRGBtoRGBPixelAlpha() */
+static __inline__ __m128i BlendRGBtoRGBPixelAlphaSSE2(__m128i s, __m128i d)
+{
+	const __m128i rgbmask = _mm_set1_epi32(0x00ffffff);
+	__m128i alpha = _mm_srli_epi32(s, 24);
+	__m128i opaque = _mm_cmpeq_epi32(alpha,
+					 _mm_set1_epi32(SDL_ALPHA_OPAQUE));
+	__m128i blend;
+
+	alpha = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 16));
+	blend = _mm_or_si128(
+		SDL_blend32_sse2(s, d, alpha, _mm_set1_epi32(0x00ff00ff)),
+		SDL_blend32_sse2(s, d, alpha, _mm_set1_epi32(0x0000ff00)));
+	/* opaque pixels are copied, and transparent ones blend to 'd' */
+	blend = SDL_select_sse2(opaque, s, blend);
+	return SDL_select_sse2(rgbmask, blend, d);
+}
+
+/* fast ARGB888->(A)RGB888 blending with pixel alpha */
+static void BlitRGBtoRGBPixelAlphaSSE2(SDL_BlitInfo *info)
+{
+	int width = info->d_width;
+	int height = info->d_height;
+	Uint32 *srcp = (Uint32 *)info->s_pixels;
+	int srcskip = info->s_skip >> 2;
+	Uint32 *dstp = (Uint32 *)info->d_pixels;
+	int dstskip = info->d_skip >> 2;
+	const __m128i amask = _mm_set1_epi32(0xff000000);
+	const __m128i rgbmask = _mm_set1_epi32(0x00ffffff);
+	const __m128i zero = _mm_setzero_si128();
+
+	while(height--) {
+	    int n;
+	    for(n = width; n >= 4; n -= 4, srcp += 4, dstp += 4) {
+		__m128i s = _mm_loadu_si128((__m128i *)srcp);
+		__m128i a = _mm_and_si128(s, amask);
+		__m128i d;
+
+		/* skip runs of transparent pixels, copy opaque ones */
+		if(_mm_movemask_epi8(_mm_cmpeq_epi32(a, zero)) == 0xffff)
+		    continue;
+		d = _mm_loadu_si128((__m128i *)dstp);
+		if(_mm_movemask_epi8(_mm_cmpeq_epi32(a, amask)) == 0xffff)
+		    d = SDL_select_sse2(rgbmask, s, d);
+		else
+		    d = BlendRGBtoRGBPixelAlphaSSE2(s, d);
+		_mm_storeu_si128((__m128i *)dstp, d);
+	    }
+	    if(n) {
+		Uint32 buf[8] = { 0 };
+		SDL_memcpy(buf, srcp, n * 4);
+		SDL_memcpy(buf + 4, dstp, n * 4);
+		_mm_storeu_si128((__m128i *)(buf + 4),
+			BlendRGBtoRGBPixelAlphaSSE2(
+				_mm_loadu_si128((__m128i *)buf),
+				_mm_loadu_si128((__m128i *)(buf + 4))));
+		SDL_memcpy(dstp, buf + 4, n * 4);
+		srcp += n;
+		dstp += n;
+	    }
+	    srcp += srcskip;
+	    dstp += dstskip;
+	}
+}
+
+/*
+ * Four pixels of BlitRGBtoRGBSurfaceAlpha().  Its unrolled loop blends
+ * the green of two pixels at once, which rounds differently, so with
+ * 'pairs' set that is done for pixels 0,1 and 2,3 here too.
+ */
+static __inline__ __m128i BlendRGBtoRGBSurfaceAlphaSSE2(__m128i s, __m128i d,
+					unsigned alpha, __m128i a, int pairs)
+{
+	const __m128i opaque = _mm_set1_epi32(0xff000000);
+	const __m128i rbmask = _mm_set1_epi32(0x00ff00ff);
+	__m128i g;
+
+	if(alpha == 128) {
+		/* ((s + d) >> 1) per channel, as BlitRGBtoRGBSurfaceAlpha128 */
+		const __m128i mask = _mm_set1_epi32(0x00fefefe);
+		d = _mm_add_epi32(_mm_srli_epi32(_mm_add_epi32(
+				_mm_and_si128(s, mask),
+				_mm_and_si128(d, mask)), 1),
+			_mm_and_si128(_mm_and_si128(s, d),
+				      _mm_set1_epi32(0x00010101)));
+		return _mm_or_si128(d, opaque);
+	}
+	if(pairs) {
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i gmask = _mm_set1_epi32(0xff);
+		__m128i sg = _mm_packs_epi32(
+			_mm_and_si128(_mm_srli_epi32(s, 8), gmask), zero);
+		g = _mm_packs_epi32(
+			_mm_and_si128(_mm_srli_epi32(d, 8), gmask), zero);
+		g = SDL_blend32_sse2(sg, g, a, rbmask);
+		g = _mm_slli_epi32(_mm_unpacklo_epi16(g, zero), 8);
+	} else {
+		g = SDL_blend32_sse2(s, d, a, _mm_set1_epi32(0x0000ff00));
+	}
+	return _mm_or_si128(_mm_or_si128(SDL_blend32_sse2(s, d, a, rbmask), g),
+			    opaque);
+}
+
+/* fast RGB888->(A)RGB888 blending with surface alpha */
+static void BlitRGBtoRGBSurfaceAlphaSSE2(SDL_BlitInfo *info)
+{
+	unsigned alpha = info->src->alpha;
+	int width = info->d_width;
+	int height = info->d_height;
+	Uint32 *srcp = (Uint32 *)info->s_pixels;
+	int srcskip = info->s_skip >> 2;
+	Uint32 *dstp = (Uint32 *)info->d_pixels;
+	int dstskip = info->d_skip >> 2;
+	const __m128i a = _mm_set1_epi32(alpha | alpha << 16);
+	Uint32 buf[8] = { 0 };
+
+	while(height--) {
+	    int n = width;
+	    /* an odd pixel goes first on its own, like DUFFS_LOOP_DOUBLE2 */
+	    if(n & 1) {
+		buf[0] = *srcp++;
+		buf[4] = *dstp;
+		_mm_storeu_si128((__m128i *)(buf + 4),
+			BlendRGBtoRGBSurfaceAlphaSSE2(
+				_mm_loadu_si128((__m128i *)buf),
+				_mm_loadu_si128((__m128i *)(buf + 4)),
+				alpha, a, 0));
+		*dstp++ = buf[4];
+		n--;
+	    }
+	    for( ; n >= 4; n -= 4, srcp += 4, dstp += 4) {
+		_mm_storeu_si128((__m128i *)dstp,
+			BlendRGBtoRGBSurfaceAlphaSSE2(
+				_mm_loadu_si128((__m128i *)srcp),
+				_mm_loadu_si128((__m128i *)dstp),
+				alpha, a, 1));
+	    }
+	    if(n) {
+		buf[0] = srcp[0];
+		buf[1] = srcp[1];
+		buf[4] = dstp[0];
+		buf[5] = dstp[1];
+		_mm_storeu_si128((__m128i *)(buf + 4),
+			BlendRGBtoRGBSurfaceAlphaSSE2(
+				_mm_loadu_si128((__m128i *)buf),
+				_mm_loadu_si128((__m128i *)(buf + 4)),
+				alpha, a, 1));
+		dstp[0] = buf[4];
+		dstp[1] = buf[5];
+		srcp += 2;
+		dstp += 2;
+	    }
+	    srcp += srcskip;
+	    dstp += dstskip;
+	}
+}
+
+/* Spread 16-bit pixels in 32-bit lanes to G0RAB65565 (or 555) layout */
+static __inline__ __m128i SDL_spread16_sse2(__m128i x, __m128i mask)
+{
+	return _mm_and_si128(_mm_or_si128(x, _mm_slli_epi32(x, 16)), mask);
+}
+
+/* Pack the 16-bit pixels of two spread vectors back together */
+static __inline__ __m128i SDL_pack16_sse2(__m128i lo, __m128i hi)
+{
+	lo = _mm_or_si128(lo, _mm_srli_epi32(lo, 16));
+	hi = _mm_or_si128(hi, _mm_srli_epi32(hi, 16));
+	/* sign extend the low halves, so packing doesn't saturate */
+	lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+	hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+	return _mm_packs_epi32(lo, hi);
+}
+
+/* d + ((s - d) * alpha >> 5) on spread 16-bit pixels */
+static __inline__ __m128i SDL_blend16_sse2(__m128i s, __m128i d,
+					   __m128i alpha, __m128i mask)
+{
+	d = _mm_add_epi32(d, _mm_srli_epi32(
+		SDL_mul32_sse2(_mm_sub_epi32(s, d), alpha), 5));
+	return _mm_and_si128(d, mask);
+}
+
+/* Eight pixels of Blit565to565SurfaceAlpha() or Blit555to555SurfaceAlpha() */
+static __inline__ __m128i Blend16SurfaceAlphaSSE2(__m128i s, __m128i d,
+			unsigned alpha, __m128i a, __m128i mask, Uint16 mask50)
+{
+	const __m128i zero = _mm_setzero_si128();
+	__m128i lo, hi;
+
+	if(alpha == 128) {
+		/* BLEND16_50() on each pixel */
+		const __m128i m = _mm_set1_epi16((short)mask50);
+		return _mm_add_epi16(_mm_add_epi16(
+				_mm_srli_epi16(_mm_and_si128(s, m), 1),
+				_mm_srli_epi16(_mm_and_si128(d, m), 1)),
+			_mm_andnot_si128(m, _mm_and_si128(s, d)));
+	}
+	lo = SDL_blend16_sse2(
+		SDL_spread16_sse2(_mm_unpacklo_epi16(s, zero), mask),
+		SDL_spread16_sse2(_mm_unpacklo_epi16(d, zero), mask), a, mask);
+	hi = SDL_blend16_sse2(
+		SDL_spread16_sse2(_mm_unpackhi_epi16(s, zero), mask),
+		SDL_spread16_sse2(_mm_unpackhi_epi16(d, zero), mask), a, mask);
+	return SDL_pack16_sse2(lo, hi);
+}
+
+/* fast RGB565->RGB565 and RGB555->RGB555 blending with surface alpha */
+static void Blit16to16SurfaceAlphaSSE2(SDL_BlitInfo *info,
+				       Uint32 spread, Uint16 mask50)
+{
+	unsigned alpha = info->src->alpha;
+	int width = info->d_width;
+	int height = info->d_height;
+	Uint16 *srcp = (Uint16 *)info->s_pixels;
+	int srcskip = info->s_skip >> 1;
+	Uint16 *dstp = (Uint16 *)info->d_pixels;
+	int dstskip = info->d_skip >> 1;
+	const __m128i mask = _mm_set1_epi32(spread);
+	const __m128i a = _mm_set1_epi32((alpha >> 3) | (alpha >> 3) << 16);
+
+	while(height--) {
+	    int n;
+	    for(n = width; n >= 8; n -= 8, srcp += 8, dstp += 8) {
+		_mm_storeu_si128((__m128i *)dstp,
+			Blend16SurfaceAlphaSSE2(
+				_mm_loadu_si128((__m128i *)srcp),
+				_mm_loadu_si128((__m128i *)dstp),
+				alpha, a, mask, mask50));
+	    }
+	    if(n) {
+		Uint16 buf[16] = { 0 };
+		SDL_memcpy(buf, srcp, n * 2);
+		SDL_memcpy(buf + 8, dstp, n * 2);
+		_mm_storeu_si128((__m128i *)(buf + 8),
+			Blend16SurfaceAlphaSSE2(
+				_mm_loadu_si128((__m128i *)buf),
+				_mm_loadu_si128((__m128i *)(buf + 8)),
+				alpha, a, mask, mask50));
+		SDL_memcpy(dstp, buf + 8, n * 2);
+		srcp += n;
+		dstp += n;
+	    }
+	    srcp += srcskip;
+	    dstp += dstskip;
+	}
+}
+
+static void Blit565to565SurfaceAlphaSSE2(SDL_BlitInfo *info)
+{
+	Blit16to16SurfaceAlphaSSE2(info, 0x07e0f81f, 0xf7de);
+}
+
+static void Blit555to555SurfaceAlphaSSE2(SDL_BlitInfo *info)
+{
+	Blit16to16SurfaceAlphaSSE2(info, 0x03e07c1f, 0xfbde);
+}
+
+/* Four pixels of BlitARGBto565PixelAlpha() or BlitARGBto555PixelAlpha() */
+static __inline__ __m128i BlendARGBto16PixelAlphaSSE2(__m128i s, __m128i d,
+							int is565)
+{
+	const __m128i blue = _mm_set1_epi32(0x1f);
+	__m128i alpha = _mm_srli_epi32(s, 27);	/* downscale alpha to 5 bits */
+	__m128i opaque = _mm_cmpeq_epi32(alpha, _mm_set1_epi32(0x1f));
+	__m128i transparent = _mm_cmpeq_epi32(alpha, _mm_setzero_si128());
+	__m128i copy, mask, blend;
+
+	copy = _mm_and_si128(_mm_srli_epi32(s, 3), blue);
+	if(is565) {
+		mask = _mm_set1_epi32(0x07e0f81f);
+		copy = _mm_add_epi32(copy, _mm_add_epi32(
+			_mm_and_si128(_mm_srli_epi32(s, 8),
+				      _mm_set1_epi32(0xf800)),
+			_mm_and_si128(_mm_srli_epi32(s, 5),
+				      _mm_set1_epi32(0x7e0))));
+		/* convert the source to G0RAB65565 */
+		s = _mm_add_epi32(_mm_add_epi32(
+			_mm_slli_epi32(_mm_and_si128(s,
+				_mm_set1_epi32(0xfc00)), 11),
+			_mm_and_si128(_mm_srli_epi32(s, 8),
+				      _mm_set1_epi32(0xf800))),
+			_mm_and_si128(_mm_srli_epi32(s, 3), blue));
+	} else {
+		mask = _mm_set1_epi32(0x03e07c1f);
+		copy = _mm_add_epi32(copy, _mm_add_epi32(
+			_mm_and_si128(_mm_srli_epi32(s, 9),
+				      _mm_set1_epi32(0x7c00)),
+			_mm_and_si128(_mm_srli_epi32(s, 6),
+				      _mm_set1_epi32(0x3e0))));
+		s = _mm_add_epi32(_mm_add_epi32(
+			_mm_slli_epi32(_mm_and_si128(s,
+				_mm_set1_epi32(0xf800)), 10),
+			_mm_and_si128(_mm_srli_epi32(s, 9),
+				      _mm_set1_epi32(0x7c00))),
+			_mm_and_si128(_mm_srli_epi32(s, 3), blue));
+	}
+	alpha = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 16));
+	blend = SDL_blend16_sse2(s, SDL_spread16_sse2(d, mask), alpha, mask);
+	blend = _mm_and_si128(_mm_or_si128(blend, _mm_srli_epi32(blend, 16)),
+			      _mm_set1_epi32(0xffff));
+	blend = SDL_select_sse2(opaque, copy, blend);
+	/* transparent pixels are left alone, even the unused bit of 555 */
+	return SDL_select_sse2(transparent, d, blend);
+}
+
+/* fast ARGB8888->RGB565 and ARGB8888->RGB555 blending with pixel alpha */
+static void BlitARGBto16PixelAlphaSSE2(SDL_BlitInfo *info, int is565)
+{
+	int width = info->d_width;
+	int height = info->d_height;
+	Uint32 *srcp = (Uint32 *)info->s_pixels;
+	int srcskip = info->s_skip >> 2;
+	Uint16 *dstp = (Uint16 *)info->d_pixels;
+	int dstskip = info->d_skip >> 1;
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i amask = _mm_set1_epi32(0xf8000000);
+
+	while(height--) {
+	    int n;
+	    for(n = width; n >= 4; n -= 4, srcp += 4, dstp += 4) {
+		__m128i s = _mm_loadu_si128((__m128i *)srcp);
+		__m128i a = _mm_and_si128(s, amask);
+		__m128i d;
+
+		/* skip runs of transparent pixels */
+		if(_mm_movemask_epi8(_mm_cmpeq_epi32(a, zero)) == 0xffff)
+		    continue;
+		d = _mm_unpacklo_epi16(
+			_mm_loadl_epi64((__m128i *)dstp), zero);
+		d = BlendARGBto16PixelAlphaSSE2(s, d, is565);
+		d = _mm_srai_epi32(_mm_slli_epi32(d, 16), 16);
+		_mm_storel_epi64((__m128i *)dstp, _mm_packs_epi32(d, d));
+	    }
+	    if(n) {
+		Uint32 buf[8] = { 0 };
+		int i;
+		SDL_memcpy(buf, srcp, n * 4);
+		for(i = 0; i < n; i++)
+		    buf[4 + i] = dstp[i];
+		_mm_storeu_si128((__m128i *)(buf + 4),
+			BlendARGBto16PixelAlphaSSE2(
+				_mm_loadu_si128((__m128i *)buf),
+				_mm_loadu_si128((__m128i *)(buf + 4)),
+				is565));
+		for(i = 0; i < n; i++)
+		    dstp[i] = (Uint16)buf[4 + i];
+		srcp += n;
+		dstp += n;
+	    }
+	    srcp += srcskip;
+	    dstp += dstskip;
+	}
+}
+
+static void BlitARGBto565PixelAlphaSSE2(SDL_BlitInfo *info)
+{
+	BlitARGBto16PixelAlphaSSE2(info, 1);
+}
+
+static void BlitARGBto555PixelAlphaSSE2(SDL_BlitInfo *info)
+{
+	BlitARGBto16PixelAlphaSSE2(info, 0);
+}
+
+/*
+ * 32->32 blending between any two byte aligned channel orders.  The
+ * source channels are shifted into the destination's order, and then
+ * ALPHA_BLEND() is done on every byte with the alpha (or zero, for the
+ * byte that isn't RGB) in 16-bit lanes.
+ */
+typedef struct {
+	__m128i sshift[3];	/* source R, G, B shift */
+	__m128i dshift[3];	/* destination R, G, B shift */
+	__m128i ashift;		/* source alpha shift */
+	__m128i rgbmask;	/* destination RGB bytes */
+	__m128i keep;		/* destination bytes to keep or set */
+} SDL_SwizzleSSE2;
+
+static void SDL_SetupSwizzleSSE2(SDL_SwizzleSSE2 *sw,
+				 SDL_PixelFormat *sf, SDL_PixelFormat *df)
+{
+	sw->sshift[0] = _mm_cvtsi32_si128(sf->Rshift);
+	sw->sshift[1] = _mm_cvtsi32_si128(sf->Gshift);
+	sw->sshift[2] = _mm_cvtsi32_si128(sf->Bshift);
+	sw->dshift[0] = _mm_cvtsi32_si128(df->Rshift);
+	sw->dshift[1] = _mm_cvtsi32_si128(df->Gshift);
+	sw->dshift[2] = _mm_cvtsi32_si128(df->Bshift);
+	sw->ashift = _mm_cvtsi32_si128(sf->Ashift);
+	sw->rgbmask = _mm_set1_epi32(df->Rmask | df->Gmask | df->Bmask);
+	sw->keep = _mm_set1_epi32(df->Amask);
+}
+
+static __inline__ __m128i SDL_SwizzleRGB_sse2(const SDL_SwizzleSSE2 *sw,
+					      __m128i s)
+{
+	const __m128i ff = _mm_set1_epi32(0xff);
+	__m128i r, g, b;
+
+	r = _mm_and_si128(_mm_srl_epi32(s, sw->sshift[0]), ff);
+	g = _mm_and_si128(_mm_srl_epi32(s, sw->sshift[1]), ff);
+	b = _mm_and_si128(_mm_srl_epi32(s, sw->sshift[2]), ff);
+	return _mm_or_si128(_mm_or_si128(_mm_sll_epi32(r, sw->dshift[0]),
+					 _mm_sll_epi32(g, sw->dshift[1])),
+			    _mm_sll_epi32(b, sw->dshift[2]));
+}
+
+/* ALPHA_BLEND() on every byte, with the factor for each byte in 'a' */
+static __inline__ __m128i SDL_AlphaBlendBytes_sse2(__m128i s, __m128i d,
+						   __m128i a)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i round = _mm_set1_epi16(255);
+	const __m128i ff = _mm_set1_epi16(0xff);
+	__m128i lo, hi, t;
+
+	/* only bits 8-15 are needed, so the 16-bit lanes can overflow */
+	lo = _mm_unpacklo_epi8(d, zero);
+	t = _mm_mullo_epi16(_mm_sub_epi16(_mm_unpacklo_epi8(s, zero), lo),
+			    _mm_unpacklo_epi8(a, zero));
+	t = _mm_srli_epi16(_mm_add_epi16(t, round), 8);
+	lo = _mm_and_si128(_mm_add_epi16(lo, t), ff);
+
+	hi = _mm_unpackhi_epi8(d, zero);
+	t = _mm_mullo_epi16(_mm_sub_epi16(_mm_unpackhi_epi8(s, zero), hi),
+			    _mm_unpackhi_epi8(a, zero));
+	t = _mm_srli_epi16(_mm_add_epi16(t, round), 8);
+	hi = _mm_and_si128(_mm_add_epi16(hi, t), ff);
+
+	return _mm_packus_epi16(lo, hi);
+}
+
+/* Four pixels of BlitNtoNPixelAlpha() */
+static __inline__ __m128i Blend32to32PixelAlphaSSE2(const SDL_SwizzleSSE2 *sw,
+						    __m128i s, __m128i d)
+{
+	__m128i alpha, blend;
+
+	alpha = _mm_and_si128(_mm_srl_epi32(s, sw->ashift),
+			      _mm_set1_epi32(0xff));
+	blend = _mm_or_si128(alpha, _mm_slli_epi32(alpha, 8));
+	blend = _mm_and_si128(_mm_or_si128(blend, _mm_slli_epi32(blend, 16)),
+			      sw->rgbmask);
+	blend = SDL_AlphaBlendBytes_sse2(SDL_SwizzleRGB_sse2(sw, s), d, blend);
+	/* the destination alpha is kept, or cleared if there is none */
+	blend = _mm_and_si128(blend, _mm_or_si128(sw->rgbmask, sw->keep));
+	return SDL_select_sse2(_mm_cmpeq_epi32(alpha, _mm_setzero_si128()),
+			       d, blend);
+}
+
+/* fast N->N blending with pixel alpha, for 32 bit byte aligned formats */
+static void Blit32to32PixelAlphaSSE2(SDL_BlitInfo *info)
+{
+	int width = info->d_width;
+	int height = info->d_height;
+	Uint32 *srcp = (Uint32 *)info->s_pixels;
+	int srcskip = info->s_skip >> 2;
+	Uint32 *dstp = (Uint32 *)info->d_pixels;
+	int dstskip = info->d_skip >> 2;
+	const __m128i amask = _mm_set1_epi32(info->src->Amask);
+	const __m128i zero = _mm_setzero_si128();
+	SDL_SwizzleSSE2 sw;
+
+	SDL_SetupSwizzleSSE2(&sw, info->src, info->dst);
+	while(height--) {
+	    int n;
+	    for(n = width; n >= 4; n -= 4, srcp += 4, dstp += 4) {
+		__m128i s = _mm_loadu_si128((__m128i *)srcp);
+
+		/* skip runs of transparent pixels */
+		if(_mm_movemask_epi8(_mm_cmpeq_epi32(
+			_mm_and_si128(s, amask), zero)) == 0xffff)
+		    continue;
+		_mm_storeu_si128((__m128i *)dstp,
+			Blend32to32PixelAlphaSSE2(&sw, s,
+				_mm_loadu_si128((__m128i *)dstp)));
+	    }
+	    if(n) {
+		Uint32 buf[8] = { 0 };
+		SDL_memcpy(buf, srcp, n * 4);
+		SDL_memcpy(buf + 4, dstp, n * 4);
+		_mm_storeu_si128((__m128i *)(buf + 4),
+			Blend32to32PixelAlphaSSE2(&sw,
+				_mm_loadu_si128((__m128i *)buf),
+				_mm_loadu_si128((__m128i *)(buf + 4))));
+		SDL_memcpy(dstp, buf + 4, n * 4);
+		srcp += n;
+		dstp += n;
+	    }
+	    srcp += srcskip;
+	    dstp += dstskip;
+	}
+}
+
+/* Four pixels of BlitNtoNSurfaceAlpha(), 'a' being the alpha per byte */
+static __inline__ __m128i Blend32to32SurfaceAlphaSSE2(const SDL_SwizzleSSE2 *sw,
+						__m128i s, __m128i d, __m128i a)
+{
+	d = SDL_AlphaBlendBytes_sse2(SDL_SwizzleRGB_sse2(sw, s), d, a);
+	/* the destination alpha becomes opaque */
+	return _mm_or_si128(_mm_and_si128(d, sw->rgbmask), sw->keep);
+}
+
+/* fast N->N blending with surface alpha, for 32 bit byte aligned formats */
+static void Blit32to32SurfaceAlphaSSE2(SDL_BlitInfo *info)
+{
+	unsigned alpha = info->src->alpha;
+	int width = info->d_width;
+	int height = info->d_height;
+	Uint32 *srcp = (Uint32 *)info->s_pixels;
+	int srcskip = info->s_skip >> 2;
+	Uint32 *dstp = (Uint32 *)info->d_pixels;
+	int dstskip = info->d_skip >> 2;
+	SDL_SwizzleSSE2 sw;
+	__m128i a;
+
+	if(!alpha)
+	    return;
+	SDL_SetupSwizzleSSE2(&sw, info->src, info->dst);
+	a = _mm_and_si128(_mm_set1_epi8((char)alpha), sw.rgbmask);
+	while(height--) {
+	    int n;
+	    for(n = width; n >= 4; n -= 4, srcp += 4, dstp += 4) {
+		_mm_storeu_si128((__m128i *)dstp,
+			Blend32to32SurfaceAlphaSSE2(&sw,
+				_mm_loadu_si128((__m128i *)srcp),
+				_mm_loadu_si128((__m128i *)dstp), a));
+	    }
+	    if(n) {
+		Uint32 buf[8] = { 0 };
+		SDL_memcpy(buf, srcp, n * 4);
+		SDL_memcpy(buf + 4, dstp, n * 4);
+		_mm_storeu_si128((__m128i *)(buf + 4),
+			Blend32to32SurfaceAlphaSSE2(&sw,
+				_mm_loadu_si128((__m128i *)buf),
+				_mm_loadu_si128((__m128i *)(buf + 4)), a));
+		SDL_memcpy(dstp, buf + 4, n * 4);
+		srcp += n;
+		dstp += n;
+	    }
+	    srcp += srcskip;
+	    dstp += dstskip;
+	}
+}
+
+/* Whether the RGB (and alpha) channels of a 32 bit format are whole bytes */
+static int SDL_IsByteFormatSSE2(SDL_PixelFormat *fmt, int alpha)
+{
+	if(fmt->BytesPerPixel != 4
+	   || fmt->Rloss || fmt->Gloss || fmt->Bloss
+	   || fmt->Rshift % 8 || fmt->Gshift % 8 || fmt->Bshift % 8)
+		return 0;
+	if(alpha && (fmt->Aloss || fmt->Ashift % 8))
+		return 0;
+	return 1;
+}
+#endif /* SSE2_ASMBLIT */
+
 SDL_loblit SDL_CalculateAlphaBlit(SDL_Surface *surface, int blit_index)
 {
     SDL_PixelFormat *sf = surface->format;
@@ -2751,6 +3353,11 @@ SDL_loblit SDL_CalculateAlphaBlit(SDL_Surface *surface, int blit_index)
 		if(SDL_HasMMX())
 			return Blit565to565SurfaceAlphaMMX;
 		else
+#endif
+#if SSE2_ASMBLIT
+		if(SDL_HasSSE2())
+			return Blit565to565SurfaceAlphaSSE2;
+		else
 #endif
 			return Blit565to565SurfaceAlpha;
 		    }
@@ -2760,6 +3367,11 @@ SDL_loblit SDL_CalculateAlphaBlit(SDL_Surface *surface, int blit_index)
 		if(SDL_HasMMX())
 			return Blit555to555SurfaceAlphaMMX;
 		else
+#endif
+#if SSE2_ASMBLIT
+		if(SDL_HasSSE2())
+			return Blit555to555SurfaceAlphaSSE2;
+		else
 #endif
 			return Blit555to555SurfaceAlpha;
 		    }
@@ -2785,6 +3397,10 @@ SDL_loblit SDL_CalculateAlphaBlit(SDL_Surface *surface, int blit_index)
 				if(!(surface->map->dst->flags & SDL_HWSURFACE)
 					&& SDL_HasAltiVec())
 					return BlitRGBtoRGBSurfaceAlphaAltivec;
+#endif
+#if SSE2_ASMBLIT
+				if(SDL_HasSSE2())
+					return BlitRGBtoRGBSurfaceAlphaSSE2;
 #endif
 				return BlitRGBtoRGBSurfaceAlpha;
 			}
@@ -2794,6 +3410,12 @@ SDL_loblit SDL_CalculateAlphaBlit(SDL_Surface *surface, int blit_index)
 		   !(surface->map->dst->flags & SDL_HWSURFACE) && SDL_HasAltiVec())
 			return Blit32to32SurfaceAlphaAltivec;
 		else
+#endif
+#if SSE2_ASMBLIT
+		if(SDL_IsByteFormatSSE2(sf, 0) &&
+		   SDL_IsByteFormatSSE2(df, df->Amask != 0) && SDL_HasSSE2())
+			return Blit32to32SurfaceAlphaSSE2;
+		else
 #endif
 			return BlitNtoNSurfaceAlpha;
 
@@ -2820,6 +3442,14 @@ SDL_loblit SDL_CalculateAlphaBlit(SDL_Surface *surface, int blit_index)
 	       && sf->Gmask == 0xff00
 	       && ((sf->Rmask == 0xff && df->Rmask == 0x1f)
 		   || (sf->Bmask == 0xff && df->Bmask == 0x1f))) {
+#if SSE2_ASMBLIT
+		if(SDL_HasSSE2()) {
+		    if(df->Gmask == 0x7e0)
+			return BlitARGBto565PixelAlphaSSE2;
+		    else if(df->Gmask == 0x3e0)
+			return BlitARGBto555PixelAlphaSSE2;
+		}
+#endif
 		if(df->Gmask == 0x7e0)
 		    return BlitARGBto565PixelAlpha;
 		else if(df->Gmask == 0x3e0)
@@ -2852,6 +3482,10 @@ SDL_loblit SDL_CalculateAlphaBlit(SDL_Surface *surface, int blit_index)
 			if(!(surface->map->dst->flags & SDL_HWSURFACE)
 				&& SDL_HasAltiVec())
 				return BlitRGBtoRGBPixelAlphaAltivec;
+#endif
+#if SSE2_ASMBLIT
+			if(SDL_HasSSE2())
+				return BlitRGBtoRGBPixelAlphaSSE2;
 #endif
 			return BlitRGBtoRGBPixelAlpha;
 		}
@@ -2861,6 +3495,12 @@ SDL_loblit SDL_CalculateAlphaBlit(SDL_Surface *surface, int blit_index)
 	        !(surface->map->dst->flags & SDL_HWSURFACE) && SDL_HasAltiVec())
 		return Blit32to32PixelAlphaAltivec;
 	    else
+#endif
+#if SSE2_ASMBLIT
+	    if(SDL_IsByteFormatSSE2(sf, 1) &&
+	       SDL_IsByteFormatSSE2(df, df->Amask != 0) && SDL_HasSSE2())
+		return Blit32to32PixelAlphaSSE2;
+	    else
 #endif
 		return BlitNtoNPixelAlpha;
 
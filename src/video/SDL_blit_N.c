@@ -26,6 +26,13 @@
 #include "SDL_cpuinfo.h"
 #include "SDL_blit.h"
 
+/* SSE2 is always there on x86-64, and any x86 build that enables it */
+#if SDL_ASSEMBLY_ROUTINES && \
+    (defined(__SSE2__) || (defined(_MSC_VER) && defined(_M_X64)))
+#define SSE2_ASMBLIT 1
+#include <emmintrin.h>
+#endif
+
 /* Functions to blit from N-bit surfaces to other surfaces */
 
 #if SDL_ALTIVEC_BLITTERS
@@ -837,8 +844,9 @@ static Uint32 GetBlitFeatures( void )
 #pragma altivec_model off
 #endif
 #else
-/* Feature 1 is has-MMX */
-#define GetBlitFeatures() ((Uint32)(SDL_HasMMX() ? 1 : 0))
+/* Feature 1 is has-MMX, feature 8 is has-SSE2 */
+#define GetBlitFeatures() \
+	((Uint32)((SDL_HasMMX() ? 1 : 0) | (SDL_HasSSE2() ? 8 : 0)))
 #endif
 
 /* This is now endian dependent */
@@ -2269,6 +2277,465 @@ static void BlitNtoNKeyCopyAlpha(SDL_BlitInfo *info)
 	}
 }
 
+#if SSE2_ASMBLIT
+/*
+ * The SSE2 converters work on four pixels at a time, one per 32-bit lane.
+ * Each source channel is masked and shifted into its place in the
+ * destination format, and the channels that move by the same amount
+ * share a mask, so most swizzles take three or four of them.  This gives
+ * the same pixels as BlitNtoN() and BlitNtoNCopyAlpha() for any 16, 24
+ * and 32 bit formats.
+ */
+#define SSE2_CONVERT_TERMS	4
+
+typedef struct {
+	int nterms;
+	int nleft;		/* the first 'nleft' terms shift left */
+	__m128i mask[SSE2_CONVERT_TERMS];
+	__m128i shift[SSE2_CONVERT_TERMS];
+	__m128i alpha;		/* bits set in every destination pixel */
+} SDL_ConvertSSE2;
+
+/* Add the bits in 'mask', to be moved left by 'shift' (right if < 0) */
+static int SDL_AddTermSSE2(Uint32 *masks, int *shifts, int n,
+			   Uint32 mask, int shift)
+{
+	int i;
+
+	if(!mask)
+		return n;
+	for(i = 0; i < n; ++i) {
+		if(shifts[i] == shift) {
+			masks[i] |= mask;
+			return n;
+		}
+	}
+	masks[n] = mask;
+	shifts[n] = shift;
+	return n + 1;
+}
+
+/* The terms for one channel, as ((pixel&mask)>>shift<<loss)>>dloss<<dshift */
+static int SDL_AddChannelSSE2(Uint32 *masks, int *shifts, int n,
+			      Uint32 mask, int shift, int loss,
+			      int dshift, int dloss)
+{
+	if(dloss >= 8)
+		return n;	/* the destination has no such channel */
+	/* the low bits that don't fit in the destination are dropped */
+	if(dloss > loss)
+		mask &= ~(((1 << (dloss - loss)) - 1) << shift);
+	return SDL_AddTermSSE2(masks, shifts, n, mask,
+			       dshift - shift + loss - dloss);
+}
+
+static void SDL_SetupConvertSSE2(SDL_ConvertSSE2 *cv,
+				 SDL_PixelFormat *sf, SDL_PixelFormat *df)
+{
+	Uint32 masks[SSE2_CONVERT_TERMS];
+	int shifts[SSE2_CONVERT_TERMS];
+	Uint32 alpha = 0;
+	int i, n = 0;
+
+	n = SDL_AddChannelSSE2(masks, shifts, n, sf->Rmask, sf->Rshift,
+			       sf->Rloss, df->Rshift, df->Rloss);
+	n = SDL_AddChannelSSE2(masks, shifts, n, sf->Gmask, sf->Gshift,
+			       sf->Gloss, df->Gshift, df->Gloss);
+	n = SDL_AddChannelSSE2(masks, shifts, n, sf->Bmask, sf->Bshift,
+			       sf->Bloss, df->Bshift, df->Bloss);
+	if(df->Amask) {
+		if(sf->Amask)
+			n = SDL_AddChannelSSE2(masks, shifts, n,
+					       sf->Amask, sf->Ashift,
+					       sf->Aloss, df->Ashift,
+					       df->Aloss);
+		else
+			alpha = (sf->alpha >> df->Aloss) << df->Ashift;
+	}
+
+	cv->nterms = 0;
+	for(i = 0; i < n; ++i) {
+		if(shifts[i] >= 0) {
+			cv->mask[cv->nterms] = _mm_set1_epi32(masks[i]);
+			cv->shift[cv->nterms++] = _mm_cvtsi32_si128(shifts[i]);
+		}
+	}
+	cv->nleft = cv->nterms;
+	for(i = 0; i < n; ++i) {
+		if(shifts[i] < 0) {
+			cv->mask[cv->nterms] = _mm_set1_epi32(masks[i]);
+			cv->shift[cv->nterms++] = _mm_cvtsi32_si128(-shifts[i]);
+		}
+	}
+	cv->alpha = _mm_set1_epi32(alpha);
+}
+
+static __inline__ __m128i SDL_ConvertPixels_sse2(const SDL_ConvertSSE2 *cv,
+						 __m128i s)
+{
+	__m128i d = cv->alpha;
+	int i;
+
+	for(i = 0; i < cv->nleft; ++i)
+		d = _mm_or_si128(d, _mm_sll_epi32(
+			_mm_and_si128(s, cv->mask[i]), cv->shift[i]));
+	for(; i < cv->nterms; ++i)
+		d = _mm_or_si128(d, _mm_srl_epi32(
+			_mm_and_si128(s, cv->mask[i]), cv->shift[i]));
+	return d;
+}
+
+/* Four pixels of 'bpp' bytes, with any bits above them left as garbage */
+static __inline__ __m128i SDL_LoadPixels_sse2(const Uint8 *src, int bpp)
+{
+	__m128i v;
+
+	switch(bpp) {
+	    case 2:
+		return _mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i *)src),
+					  _mm_setzero_si128());
+	    case 3:
+		v = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)src),
+			_mm_cvtsi32_si128(*(const Uint32 *)(src + 8)));
+		/* the pixels start at bytes 0, 3, 6 and 9 */
+		return _mm_unpacklo_epi64(
+			_mm_unpacklo_epi32(v, _mm_srli_si128(v, 3)),
+			_mm_unpacklo_epi32(_mm_srli_si128(v, 6),
+					   _mm_srli_si128(v, 9)));
+	    default:
+		return _mm_loadu_si128((const __m128i *)src);
+	}
+}
+
+/* Store four pixels of 'bpp' bytes, ignoring any bits above them */
+static __inline__ void SDL_StorePixels_sse2(Uint8 *dst, int bpp, __m128i v)
+{
+	const __m128i lane = _mm_set_epi32(0, 0, 0, 0x00ffffff);
+
+	switch(bpp) {
+	    case 2:
+		/* sign extended, so that the pack doesn't saturate */
+		v = _mm_srai_epi32(_mm_slli_epi32(v, 16), 16);
+		_mm_storel_epi64((__m128i *)dst, _mm_packs_epi32(v, v));
+		break;
+	    case 3:
+		v = _mm_or_si128(
+			_mm_or_si128(_mm_and_si128(v, lane),
+				_mm_srli_si128(_mm_and_si128(v,
+					_mm_slli_si128(lane, 4)), 1)),
+			_mm_or_si128(
+				_mm_srli_si128(_mm_and_si128(v,
+					_mm_slli_si128(lane, 8)), 2),
+				_mm_srli_si128(_mm_and_si128(v,
+					_mm_slli_si128(lane, 12)), 3)));
+		_mm_storel_epi64((__m128i *)dst, v);
+		*(Uint32 *)(dst + 8) = _mm_cvtsi128_si32(_mm_srli_si128(v, 8));
+		break;
+	    default:
+		_mm_storeu_si128((__m128i *)dst, v);
+		break;
+	}
+}
+
+static void ConvertNtoNSSE2(SDL_BlitInfo *info, const SDL_ConvertSSE2 *cv)
+{
+	int width = info->d_width;
+	int height = info->d_height;
+	Uint8 *src = info->s_pixels;
+	int srcskip = info->s_skip;
+	Uint8 *dst = info->d_pixels;
+	int dstskip = info->d_skip;
+	int srcbpp = info->src->BytesPerPixel;
+	int dstbpp = info->dst->BytesPerPixel;
+
+	while ( height-- ) {
+		int n;
+		for ( n = width; n >= 4; n -= 4 ) {
+			SDL_StorePixels_sse2(dst, dstbpp,
+				SDL_ConvertPixels_sse2(cv,
+					SDL_LoadPixels_sse2(src, srcbpp)));
+			src += 4 * srcbpp;
+			dst += 4 * dstbpp;
+		}
+		if ( n ) {
+			/* the end of the row goes through a buffer */
+			Uint8 buf[16] = { 0 };
+			SDL_memcpy(buf, src, n * srcbpp);
+			SDL_StorePixels_sse2(buf, dstbpp,
+				SDL_ConvertPixels_sse2(cv,
+					SDL_LoadPixels_sse2(buf, srcbpp)));
+			SDL_memcpy(dst, buf, n * dstbpp);
+			src += n * srcbpp;
+			dst += n * dstbpp;
+		}
+		src += srcskip;
+		dst += dstskip;
+	}
+}
+
+/* BlitNtoN() and BlitNtoNCopyAlpha() for 16, 24 and 32 bit formats */
+static void BlitNtoNSSE2(SDL_BlitInfo *info)
+{
+	SDL_ConvertSSE2 cv;
+
+	SDL_SetupConvertSSE2(&cv, info->src, info->dst);
+	ConvertNtoNSSE2(info, &cv);
+}
+
+/* v*255/63 rounded down, for v < 64 */
+static __inline__ __m128i SDL_Expand6_sse2(__m128i v)
+{
+	return _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(v,
+		_mm_set1_epi16(259)), _mm_set1_epi16(3)), 6);
+}
+
+/*
+ * The colorkey blitters compare a whole vector of pixels with the key, and
+ * skip it if they all match.  Otherwise the matching pixels are taken from
+ * the destination, so they are stored back unchanged.
+ */
+static __inline__ void SDL_KeyPixels_sse2(const SDL_ConvertSSE2 *cv,
+					  __m128i key, __m128i rgbmask,
+					  const Uint8 *src, int srcbpp,
+					  Uint8 *dst, int dstbpp)
+{
+	__m128i s = SDL_LoadPixels_sse2(src, srcbpp);
+	__m128i keyed = _mm_cmpeq_epi32(_mm_and_si128(s, rgbmask), key);
+	int match = _mm_movemask_epi8(keyed);
+
+	if(match == 0xffff)
+		return;
+	s = SDL_ConvertPixels_sse2(cv, s);
+	if(match)
+		s = _mm_or_si128(_mm_and_si128(keyed,
+				SDL_LoadPixels_sse2(dst, dstbpp)),
+			_mm_andnot_si128(keyed, s));
+	SDL_StorePixels_sse2(dst, dstbpp, s);
+}
+
+/* BlitNtoNKey() and BlitNtoNKeyCopyAlpha() for 16, 24 and 32 bit formats */
+static void BlitNtoNKeySSE2(SDL_BlitInfo *info)
+{
+	int width = info->d_width;
+	int height = info->d_height;
+	Uint8 *src = info->s_pixels;
+	int srcskip = info->s_skip;
+	Uint8 *dst = info->d_pixels;
+	int dstskip = info->d_skip;
+	SDL_PixelFormat *srcfmt = info->src;
+	int srcbpp = srcfmt->BytesPerPixel;
+	int dstbpp = info->dst->BytesPerPixel;
+	Uint32 rgbmask = ~srcfmt->Amask;
+	Uint32 ckey = srcfmt->colorkey & rgbmask;
+	SDL_ConvertSSE2 cv;
+	__m128i key, mask;
+
+	/* the loads leave garbage above 16 and 24 bit pixels */
+	if ( srcbpp < 4 ) {
+		rgbmask &= (1 << (srcbpp * 8)) - 1;
+	}
+	key = _mm_set1_epi32(ckey);
+	mask = _mm_set1_epi32(rgbmask);
+	SDL_SetupConvertSSE2(&cv, srcfmt, info->dst);
+
+	while ( height-- ) {
+		int n;
+		for ( n = width; n >= 4; n -= 4 ) {
+			SDL_KeyPixels_sse2(&cv, key, mask,
+					   src, srcbpp, dst, dstbpp);
+			src += 4 * srcbpp;
+			dst += 4 * dstbpp;
+		}
+		if ( n ) {
+			Uint8 sbuf[16] = { 0 };
+			Uint8 dbuf[16] = { 0 };
+			SDL_memcpy(sbuf, src, n * srcbpp);
+			SDL_memcpy(dbuf, dst, n * dstbpp);
+			SDL_KeyPixels_sse2(&cv, key, mask,
+					   sbuf, srcbpp, dbuf, dstbpp);
+			SDL_memcpy(dst, dbuf, n * dstbpp);
+			src += n * srcbpp;
+			dst += n * dstbpp;
+		}
+		src += srcskip;
+		dst += dstskip;
+	}
+}
+
+/* Eight pixels of Blit2to2Key() */
+static __inline__ void SDL_Key16_sse2(__m128i key, __m128i rgbmask,
+				      const Uint16 *src, Uint16 *dst)
+{
+	__m128i s = _mm_loadu_si128((const __m128i *)src);
+	__m128i keyed = _mm_cmpeq_epi16(_mm_and_si128(s, rgbmask), key);
+	int match = _mm_movemask_epi8(keyed);
+
+	if(match == 0xffff)
+		return;
+	if(match)
+		s = _mm_or_si128(_mm_and_si128(keyed,
+				_mm_loadu_si128((const __m128i *)dst)),
+			_mm_andnot_si128(keyed, s));
+	_mm_storeu_si128((__m128i *)dst, s);
+}
+
+static void Blit2to2KeySSE2(SDL_BlitInfo *info)
+{
+	int width = info->d_width;
+	int height = info->d_height;
+	Uint16 *srcp = (Uint16 *)info->s_pixels;
+	int srcskip = info->s_skip / 2;
+	Uint16 *dstp = (Uint16 *)info->d_pixels;
+	int dstskip = info->d_skip / 2;
+	Uint32 rgbmask = ~info->src->Amask;
+	Uint32 ckey = info->src->colorkey & rgbmask;
+	__m128i key, mask;
+
+	/* a key that isn't a 16 bit pixel never matches */
+	if ( ckey > 0xFFFF ) {
+		Blit2to2Key(info);
+		return;
+	}
+	key = _mm_set1_epi16((short)ckey);
+	mask = _mm_set1_epi16((short)rgbmask);
+
+	while ( height-- ) {
+		int n;
+		for ( n = width; n >= 8; n -= 8 ) {
+			SDL_Key16_sse2(key, mask, srcp, dstp);
+			srcp += 8;
+			dstp += 8;
+		}
+		if ( n ) {
+			Uint16 sbuf[8] = { 0 };
+			Uint16 dbuf[8] = { 0 };
+			SDL_memcpy(sbuf, srcp, n * 2);
+			SDL_memcpy(dbuf, dstp, n * 2);
+			SDL_Key16_sse2(key, mask, sbuf, dbuf);
+			SDL_memcpy(dstp, dbuf, n * 2);
+			srcp += n;
+			dstp += n;
+		}
+		srcp += srcskip;
+		dstp += dstskip;
+	}
+}
+
+/*
+ * RGB565 expanded the way the Blit_RGB565_*8888() tables do it: v*255/max
+ * rounded down, with the green expanded separately for the bits in each
+ * byte of the pixel and added.  The channels are moved into their bytes
+ * of the destination with 16-bit shifts, a shift of 16 clearing them.
+ */
+typedef struct {
+	__m128i lo[4];		/* R, G, B, A shift into the low 16 bits */
+	__m128i hi[4];		/* R, G, B, A shift into the high 16 bits */
+} SDL_Expand565SSE2;
+
+static void SDL_SetupExpand565SSE2(SDL_Expand565SSE2 *ex, SDL_PixelFormat *df)
+{
+	int shifts[4];
+	int i;
+
+	shifts[0] = df->Rshift;
+	shifts[1] = df->Gshift;
+	shifts[2] = df->Bshift;
+	shifts[3] = df->Ashift;
+	for(i = 0; i < 4; ++i) {
+		ex->lo[i] = _mm_cvtsi32_si128(shifts[i] < 16 ? shifts[i] : 16);
+		ex->hi[i] = _mm_cvtsi32_si128(shifts[i] >= 16 ?
+					      shifts[i] - 16 : 16);
+	}
+}
+
+/* Eight pixels, returned in 'lo' and 'hi' */
+static __inline__ void SDL_Expand565_sse2(const SDL_Expand565SSE2 *ex,
+					  __m128i p, __m128i *lo, __m128i *hi)
+{
+	const __m128i mul5 = _mm_set1_epi16(1053);
+	const __m128i alpha = _mm_set1_epi16(0xff);
+	__m128i r, g, b, l, h;
+
+	r = _mm_srli_epi16(_mm_mullo_epi16(_mm_srli_epi16(p, 11), mul5), 7);
+	g = _mm_srli_epi16(p, 5);
+	g = _mm_add_epi16(
+		SDL_Expand6_sse2(_mm_and_si128(g, _mm_set1_epi16(0x38))),
+		SDL_Expand6_sse2(_mm_and_si128(g, _mm_set1_epi16(0x07))));
+	b = _mm_and_si128(p, _mm_set1_epi16(0x1f));
+	b = _mm_srli_epi16(_mm_mullo_epi16(b, mul5), 7);
+
+	l = _mm_or_si128(
+		_mm_or_si128(_mm_sll_epi16(r, ex->lo[0]),
+			     _mm_sll_epi16(g, ex->lo[1])),
+		_mm_or_si128(_mm_sll_epi16(b, ex->lo[2]),
+			     _mm_sll_epi16(alpha, ex->lo[3])));
+	h = _mm_or_si128(
+		_mm_or_si128(_mm_sll_epi16(r, ex->hi[0]),
+			     _mm_sll_epi16(g, ex->hi[1])),
+		_mm_or_si128(_mm_sll_epi16(b, ex->hi[2]),
+			     _mm_sll_epi16(alpha, ex->hi[3])));
+	*lo = _mm_unpacklo_epi16(l, h);
+	*hi = _mm_unpackhi_epi16(l, h);
+}
+
+/* RGB565 to the 32 bit formats of the Blit_RGB565_*8888() tables */
+static void Blit_RGB565_8888SSE2(SDL_BlitInfo *info)
+{
+	int width = info->d_width;
+	int height = info->d_height;
+	Uint16 *src = (Uint16 *)info->s_pixels;
+	int srcskip = info->s_skip / 2;
+	Uint32 *dst = (Uint32 *)info->d_pixels;
+	int dstskip = info->d_skip / 4;
+	SDL_Expand565SSE2 ex;
+	__m128i lo, hi;
+
+	SDL_SetupExpand565SSE2(&ex, info->dst);
+	while ( height-- ) {
+		int n;
+		for ( n = width; n >= 8; n -= 8 ) {
+			SDL_Expand565_sse2(&ex,
+				_mm_loadu_si128((__m128i *)src), &lo, &hi);
+			_mm_storeu_si128((__m128i *)dst, lo);
+			_mm_storeu_si128((__m128i *)(dst + 4), hi);
+			src += 8;
+			dst += 8;
+		}
+		if ( n ) {
+			Uint16 sbuf[8] = { 0 };
+			Uint32 dbuf[8];
+			SDL_memcpy(sbuf, src, n * 2);
+			SDL_Expand565_sse2(&ex,
+				_mm_loadu_si128((__m128i *)sbuf), &lo, &hi);
+			_mm_storeu_si128((__m128i *)dbuf, lo);
+			_mm_storeu_si128((__m128i *)(dbuf + 4), hi);
+			SDL_memcpy(dst, dbuf, n * 4);
+			src += n;
+			dst += n;
+		}
+		src += srcskip;
+		dst += dstskip;
+	}
+}
+
+/* Whether BlitNtoNSSE2() stores the same pixels as BlitNtoN() would */
+static int SDL_CanConvertSSE2(SDL_PixelFormat *sf, SDL_PixelFormat *df)
+{
+	/* channels of more than 8 bits don't work with either */
+	if ( sf->Rloss > 8 || sf->Gloss > 8 || sf->Bloss > 8 || sf->Aloss > 8 ||
+	     df->Rloss > 8 || df->Gloss > 8 || df->Bloss > 8 || df->Aloss > 8 ) {
+		return 0;
+	}
+	/* 24 bit pixels are stored a byte at a time, without alpha */
+	if ( df->BytesPerPixel == 3 &&
+	     (df->Amask || df->Rloss || df->Gloss || df->Bloss ||
+	      df->Rshift % 8 || df->Gshift % 8 || df->Bshift % 8) ) {
+		return 0;
+	}
+	return 1;
+}
+#endif /* SSE2_ASMBLIT */
+
 /* Normal N to N optimized blitters */
 struct blit_table {
 	Uint32 srcR, srcG, srcB;
@@ -2297,6 +2764,17 @@ static const struct blit_table normal_blit_2[] = {
       2, NULL, Blit_RGB565_32Altivec, NO_ALPHA | COPY_ALPHA | SET_ALPHA },
     { 0x00007C00,0x000003E0,0x0000001F, 4, 0x00000000,0x00000000,0x00000000,
       2, NULL, Blit_RGB555_32Altivec, NO_ALPHA | COPY_ALPHA | SET_ALPHA },
+#endif
+#if SSE2_ASMBLIT
+    /* has-sse2 */
+    { 0x0000F800,0x000007E0,0x0000001F, 4, 0x00FF0000,0x0000FF00,0x000000FF,
+      8, NULL, Blit_RGB565_8888SSE2, SET_ALPHA },
+    { 0x0000F800,0x000007E0,0x0000001F, 4, 0x000000FF,0x0000FF00,0x00FF0000,
+      8, NULL, Blit_RGB565_8888SSE2, SET_ALPHA },
+    { 0x0000F800,0x000007E0,0x0000001F, 4, 0xFF000000,0x00FF0000,0x0000FF00,
+      8, NULL, Blit_RGB565_8888SSE2, SET_ALPHA },
+    { 0x0000F800,0x000007E0,0x0000001F, 4, 0x0000FF00,0x00FF0000,0xFF000000,
+      8, NULL, Blit_RGB565_8888SSE2, SET_ALPHA },
 #endif
     { 0x0000F800,0x000007E0,0x0000001F, 4, 0x00FF0000,0x0000FF00,0x000000FF,
       0, NULL, Blit_RGB565_ARGB8888, SET_ALPHA },
@@ -2306,12 +2784,30 @@ static const struct blit_table normal_blit_2[] = {
       0, NULL, Blit_RGB565_RGBA8888, SET_ALPHA },
     { 0x0000F800,0x000007E0,0x0000001F, 4, 0x0000FF00,0x00FF0000,0xFF000000,
       0, NULL, Blit_RGB565_BGRA8888, SET_ALPHA },
+#if SSE2_ASMBLIT
+    /* has-sse2 */
+    { 0x00000000,0x00000000,0x00000000, 2, 0x00000000,0x00000000,0x00000000,
+      8, NULL, BlitNtoNSSE2, NO_ALPHA | COPY_ALPHA | SET_ALPHA },
+    { 0x00000000,0x00000000,0x00000000, 3, 0x00000000,0x00000000,0x00000000,
+      8, NULL, BlitNtoNSSE2, NO_ALPHA | COPY_ALPHA | SET_ALPHA },
+    { 0x00000000,0x00000000,0x00000000, 4, 0x00000000,0x00000000,0x00000000,
+      8, NULL, BlitNtoNSSE2, NO_ALPHA | COPY_ALPHA | SET_ALPHA },
+#endif
 
     /* Default for 16-bit RGB source, used if no other blitter matches */
     { 0,0,0, 0, 0,0,0, 0, NULL, BlitNtoN, 0 }
 };
 static const struct blit_table normal_blit_3[] = {
-	/* Default for 24-bit RGB source, never optimized */
+#if SSE2_ASMBLIT
+    /* has-sse2 */
+    { 0x00000000,0x00000000,0x00000000, 2, 0x00000000,0x00000000,0x00000000,
+      8, NULL, BlitNtoNSSE2, NO_ALPHA | COPY_ALPHA | SET_ALPHA },
+    { 0x00000000,0x00000000,0x00000000, 3, 0x00000000,0x00000000,0x00000000,
+      8, NULL, BlitNtoNSSE2, NO_ALPHA | COPY_ALPHA | SET_ALPHA },
+    { 0x00000000,0x00000000,0x00000000, 4, 0x00000000,0x00000000,0x00000000,
+      8, NULL, BlitNtoNSSE2, NO_ALPHA | COPY_ALPHA | SET_ALPHA },
+#endif
+	/* Default for 24-bit RGB source */
     { 0,0,0, 0, 0,0,0, 0, NULL, BlitNtoN, 0 }
 };
 static const struct blit_table normal_blit_4[] = {
@@ -2355,6 +2851,15 @@ static const struct blit_table normal_blit_4[] = {
     /* has-altivec */
     { 0x00000000,0x00000000,0x00000000, 2, 0x0000F800,0x000007E0,0x0000001F,
       2, NULL, Blit_RGB888_RGB565Altivec, NO_ALPHA },
+#endif
+#if SSE2_ASMBLIT
+    /* has-sse2 */
+    { 0x00000000,0x00000000,0x00000000, 2, 0x00000000,0x00000000,0x00000000,
+      8, NULL, BlitNtoNSSE2, NO_ALPHA | COPY_ALPHA | SET_ALPHA },
+    { 0x00000000,0x00000000,0x00000000, 3, 0x00000000,0x00000000,0x00000000,
+      8, NULL, BlitNtoNSSE2, NO_ALPHA | COPY_ALPHA | SET_ALPHA },
+    { 0x00000000,0x00000000,0x00000000, 4, 0x00000000,0x00000000,0x00000000,
+      8, NULL, BlitNtoNSSE2, NO_ALPHA | COPY_ALPHA | SET_ALPHA },
 #endif
     { 0x00FF0000,0x0000FF00,0x000000FF, 2, 0x0000F800,0x000007E0,0x0000001F,
       0, NULL, Blit_RGB888_RGB565, NO_ALPHA },
@@ -2401,9 +2906,13 @@ SDL_loblit SDL_CalculateBlitN(SDL_Surface *surface, int blit_index)
 	       If a particular case turns out to be useful we'll add it. */
 
 	    if(srcfmt->BytesPerPixel == 2
-	       && surface->map->identity)
+	       && surface->map->identity) {
+#if SSE2_ASMBLIT
+		if(SDL_HasSSE2())
+		    return Blit2to2KeySSE2;
+#endif
 		return Blit2to2Key;
-	    else if(dstfmt->BytesPerPixel == 1)
+	    } else if(dstfmt->BytesPerPixel == 1)
 		return BlitNto1Key;
 	    else {
 #if SDL_ALTIVEC_BLITTERS
@@ -2411,6 +2920,10 @@ SDL_loblit SDL_CalculateBlitN(SDL_Surface *surface, int blit_index)
             return Blit32to32KeyAltivec;
         } else
 #endif
+#if SSE2_ASMBLIT
+		if(SDL_HasSSE2() && SDL_CanConvertSSE2(srcfmt, dstfmt))
+		    return BlitNtoNKeySSE2;
+#endif
 
 		if(srcfmt->Amask && dstfmt->Amask)
 		    return BlitNtoNKeyCopyAlpha;
@@ -2460,6 +2973,13 @@ SDL_loblit SDL_CalculateBlitN(SDL_Surface *surface, int blit_index)
 		sdata->aux_data = table[which].aux_data;
 		blitfun = table[which].blitfunc;
 
+#if SSE2_ASMBLIT
+		if ( blitfun == BlitNtoNSSE2 &&
+		     !SDL_CanConvertSSE2(srcfmt, dstfmt) ) {
+			blitfun = BlitNtoN;
+		}
+#endif
+
 		if(blitfun == BlitNtoN) {  /* default C fallback catch-all. Slow! */
 			/* Fastpath C fallback: 32bit RGB<->RGBA blit with matching RGB */
 			if ( srcfmt->BytesPerPixel == 4 && dstfmt->BytesPerPixel == 4 &&
@@ -49,7 +49,7 @@ SDL_Surface * SDL_LoadBMP_RW (SDL_RWops *src, int freesrc)
 {
 	SDL_bool was_error;
 	long fp_offset = 0;
-	int bmpPitch;
+	int bmpPitch = 0;
 	int i, pad;
 	SDL_Surface *surface;
 	Uint32 Rmask;
@@ -285,8 +285,19 @@ SDL_Surface * SDL_LoadBMP_RW (SDL_RWops *src, int freesrc)
 			case 4: {
 			Uint8 pixel = 0;
 			int   shift = (8-ExpandBMP);
+			int   avail = 0;
+			const Uint8 *packed;
+
+			/* Expand straight from a memory backed source */
+			packed = SDL_RWGetMemory(src, &avail);
+			if ( avail < bmpPitch ) {
+				packed = NULL;
+			}
 			for ( i=0; i<surface->w; ++i ) {
 				if ( i%(8/ExpandBMP) == 0 ) {
+					if ( packed ) {
+						pixel = *packed++;
+					} else
 					if ( !SDL_RWread(src, &pixel, 1, 1) ) {
 						SDL_SetError(
 					"Error reading from BMP");
@@ -296,6 +307,9 @@ SDL_Surface * SDL_LoadBMP_RW (SDL_RWops *src, int freesrc)
 				}
 				*(bits+i) = (pixel>>shift);
 				pixel <<= ExpandBMP;
+			}
+			if ( packed ) {
+				SDL_RWseek(src, bmpPitch, RW_SEEK_CUR);
 			} }
 			break;
 
@@ -330,10 +344,7 @@ SDL_Surface * SDL_LoadBMP_RW (SDL_RWops *src, int freesrc)
 		}
 		/* Skip padding bytes, ugh */
 		if ( pad ) {
-			Uint8 padbyte;
-			for ( i=0; i<pad; ++i ) {
-				SDL_RWread(src, &padbyte, 1, 1);
-			}
+			SDL_RWseek(src, pad, RW_SEEK_CUR);
 		}
 		if ( topDown ) {
 			bits += surface->pitch;
@@ -441,28 +441,17 @@ int SDL_LowerBlit (SDL_Surface *src, SDL_Rect *srcrect,
 }
 
 
-int SDL_UpperBlit (SDL_Surface *src, SDL_Rect *srcrect,
-		   SDL_Surface *dst, SDL_Rect *dstrect)
+/*
+ * Clip a blit to the source surface and the destination clip rectangle,
+ * as SDL_UpperBlit() does.  'dstrect' is updated with the final blit
+ * rectangle, and 'sr' is set to the matching source rectangle.  Returns
+ * 0 if there's nothing left to blit.
+ */
+static int SDL_ClipBlit (SDL_Surface *src, SDL_Rect *srcrect,
+			 SDL_Surface *dst, SDL_Rect *dstrect, SDL_Rect *sr)
 {
-        SDL_Rect fulldst;
 	int srcx, srcy, w, h;
 
-	/* Make sure the surfaces aren't locked */
-	if ( ! src || ! dst ) {
-		SDL_SetError("SDL_UpperBlit: passed a NULL surface");
-		return(-1);
-	}
-	if ( src->locked || dst->locked ) {
-		SDL_SetError("Surfaces must not be locked during blit");
-		return(-1);
-	}
-
-	/* If the destination rectangle is NULL, use the entire dest surface */
-	if ( dstrect == NULL ) {
-	        fulldst.x = fulldst.y = 0;
-		dstrect = &fulldst;
-	}
-
 	/* clip the source rectangle to the source surface */
 	if(srcrect) {
 	        int maxw, maxh;
@@ -522,17 +511,124 @@ int SDL_UpperBlit (SDL_Surface *src, SDL_Rect *srcrect,
 	}
 
 	if(w > 0 && h > 0) {
-	        SDL_Rect sr;
-	        sr.x = srcx;
-		sr.y = srcy;
-		sr.w = dstrect->w = w;
-		sr.h = dstrect->h = h;
-		return SDL_LowerBlit(src, &sr, dst, dstrect);
+	        sr->x = srcx;
+		sr->y = srcy;
+		sr->w = dstrect->w = w;
+		sr->h = dstrect->h = h;
+		return 1;
 	}
 	dstrect->w = dstrect->h = 0;
 	return 0;
 }
 
+int SDL_UpperBlit (SDL_Surface *src, SDL_Rect *srcrect,
+		   SDL_Surface *dst, SDL_Rect *dstrect)
+{
+        SDL_Rect fulldst;
+	SDL_Rect sr;
+
+	/* Make sure the surfaces aren't locked */
+	if ( ! src || ! dst ) {
+		SDL_SetError("SDL_UpperBlit: passed a NULL surface");
+		return(-1);
+	}
+	if ( src->locked || dst->locked ) {
+		SDL_SetError("Surfaces must not be locked during blit");
+		return(-1);
+	}
+
+	/* If the destination rectangle is NULL, use the entire dest surface */
+	if ( dstrect == NULL ) {
+	        fulldst.x = fulldst.y = 0;
+		dstrect = &fulldst;
+	}
+
+	if ( SDL_ClipBlit(src, srcrect, dst, dstrect, &sr) ) {
+		return SDL_LowerBlit(src, &sr, dst, dstrect);
+	}
+	return 0;
+}
+
+/* Order blit rectangle pairs by destination row, then column */
+static int SDL_CompareBlitRows(const void *a, const void *b)
+{
+	const SDL_Rect *A = (const SDL_Rect *)a + 1;
+	const SDL_Rect *B = (const SDL_Rect *)b + 1;
+
+	if ( A->y != B->y ) {
+		return(A->y - B->y);
+	}
+	return(A->x - B->x);
+}
+
+int SDL_BlitSurfaceBatch (SDL_Surface *src, SDL_Rect *srcrects,
+			  SDL_Surface *dst, SDL_Rect *dstrects,
+			  int n, Uint32 flags)
+{
+	SDL_Rect *rects;
+	int i, num;
+	int retval;
+
+	/* Make sure the surfaces aren't locked */
+	if ( ! src || ! dst || ! dstrects ) {
+		SDL_SetError("SDL_BlitSurfaceBatch: passed a NULL parameter");
+		return(-1);
+	}
+	if ( src->locked || dst->locked ) {
+		SDL_SetError("Surfaces must not be locked during blit");
+		return(-1);
+	}
+	if ( n <= 0 ) {
+		return(0);
+	}
+
+	/* Check the blit mapping once for the whole batch */
+	if ( (src->map->dst != dst) ||
+             (src->map->dst->format_version != src->map->format_version) ) {
+		if ( SDL_MapSurface(src, dst) < 0 ) {
+			return(-1);
+		}
+	}
+
+	/* Hardware blits go one at a time through the driver */
+	if ( (src->flags & SDL_HWACCEL) == SDL_HWACCEL ) {
+		SDL_Rect sr;
+
+		for ( i = 0; i < n; ++i ) {
+			if ( SDL_ClipBlit(src, srcrects ? &srcrects[i] : NULL,
+			                  dst, &dstrects[i], &sr) ) {
+				retval = SDL_LowerBlit(src, &sr,
+				                       dst, &dstrects[i]);
+				if ( retval < 0 ) {
+					return(retval);
+				}
+			}
+		}
+		return(0);
+	}
+
+	/* Clip everything up front, keeping source and destination pairs */
+	rects = (SDL_Rect *)SDL_malloc(2*n*sizeof(*rects));
+	if ( rects == NULL ) {
+		SDL_OutOfMemory();
+		return(-1);
+	}
+	num = 0;
+	for ( i = 0; i < n; ++i ) {
+		if ( SDL_ClipBlit(src, srcrects ? &srcrects[i] : NULL,
+		                  dst, &dstrects[i], &rects[2*num]) ) {
+			rects[2*num+1] = dstrects[i];
+			++num;
+		}
+	}
+	if ( (flags & SDL_BATCH_SORTROWS) && (num > 1) ) {
+		SDL_qsort(rects, num, 2*sizeof(*rects), SDL_CompareBlitRows);
+	}
+	retval = SDL_SoftBlitBatch(src, dst, rects, num);
+	SDL_free(rects);
+	return(retval);
+}
+
 static int SDL_FillRect1(SDL_Surface *dst, SDL_Rect *dstrect, Uint32 color)
 {
 	/* FIXME: We have to worry about packing order.. *sigh* */
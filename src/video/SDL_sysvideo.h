@@ -258,6 +258,14 @@ struct SDL_VideoDevice {
 	/* Handle any queued OS events */
 	void (*PumpEvents)(_THIS);
 
+	/* Return a file descriptor that becomes readable when there are OS
+	   events for PumpEvents, or -1 if the driver has to be polled.
+	   If PumpEvents has timed work to do, lower 'timeout' (milliseconds,
+	   -1 waits forever) to when it is due.
+	   This is optional, and only used by SDL_WaitEvent() on UNIX.
+	 */
+	int (*GetEventFD)(_THIS, int *timeout);
+
 	/* * * */
 	/* Data common to all drivers */
 	SDL_Surface *screen;
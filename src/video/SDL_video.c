@@ -283,6 +283,9 @@ int SDL_VideoInit (const char *driver_name, Uint32 flags)
 	}
 	SDL_CursorInit(flags & SDL_INIT_EVENTTHREAD);
 
+	/* Split large software blits across threads, if asked to */
+	SDL_BlitThreadsInit();
+
 	/* We're ready to go! */
 	return(0);
 }
@@ -1354,6 +1357,7 @@ void SDL_VideoQuit (void)
 
 		/* Halt event processing before doing anything else */
 		SDL_StopEventLoop();
+		SDL_BlitThreadsQuit();
 
 		/* Clean up allocated window manager items */
 		if ( SDL_PublicSurface ) {
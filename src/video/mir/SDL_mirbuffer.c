@@ -1,4 +1,9 @@
 #include "SDL_mirbuffer.h"
+#include "SDL_mircopy.h"
+#include "SDL_mirregion.h"
+#include "SDL_mirthreads.h"
+
+#include "../SDL_pixels_c.h"
 
 struct QueueNode
 {
@@ -7,80 +12,132 @@ struct QueueNode
     int num;
 };
 
-void PutPixels(_THIS, int numrects, const SDL_Rect* const rects, const MirGraphicsRegion* region)
+// Damage smaller than this isn't worth waking up the upload threads for
+#define MIN_THREADED_UPLOAD_PIXELS (256 * 256)
+
+struct UploadJob
+{
+    int numrects;
+    const SDL_Rect* rects;
+    const MirGraphicsRegion* region;
+};
+
+// Clips a rect to the rows [top, bottom) of the screen, returns SDL_FALSE
+// if nothing is left
+static SDL_bool ClipRect(_THIS, const SDL_Rect* rect, int top, int bottom, SDL_Rect* clipped)
 {
+    int x = rect->x;
+    int y = rect->y;
+    int w = rect->w;
+    int h = rect->h;
+
+    if (w <= 0 || h <= 0 || (x + w) <= 0 || (y + h) <= top)
+        return SDL_FALSE;
+
+    if (x < 0)
+    {
+        w += x;
+        x = 0;
+    }
+    if (y < top)
+    {
+        h -= top - y;
+        y = top;
+    }
+
+    if (x + w > SDL_VideoSurface->w)
+        w = SDL_VideoSurface->w - x;
+    if (y + h > bottom)
+        h = bottom - y;
+
+    if (w <= 0 || h <= 0)
+        return SDL_FALSE;
+
+    clipped->x = x;
+    clipped->y = y;
+    clipped->w = w;
+    clipped->h = h;
+
+    return SDL_TRUE;
+}
+
+// Copies the part of the job that falls inside rows [top, bottom). When the
+// screen isn't in the Mir pixel format the SDL blitters convert on the way.
+static void UploadBand(_THIS, int top, int bottom, void* data)
+{
+    const struct UploadJob* job = data;
+    const MirGraphicsRegion* region = job->region;
+
     char* s_dest = NULL;
     char* pixels = NULL;
 
-    int i, j, x, y, w, h, start;
-    int bytes_per_pixel, bytes_per_row, s_stride, d_stride;
+    int i;
+    int bytes_per_pixel, s_stride, d_stride;
+    SDL_Rect rect;
 
     s_stride = SDL_VideoSurface->pitch;
     d_stride = region->stride;
 
     bytes_per_pixel = SDL_VideoSurface->format->BytesPerPixel;
 
-    for (i = 0; i < numrects; ++i)
+    for (i = 0; i < job->numrects; ++i)
     {
-        s_dest = region->vaddr;
-        pixels = (char*)SDL_VideoSurface->pixels;
-
-        x = rects[i].x;
-        y = rects[i].y;
-        w = rects[i].w;
-        h = rects[i].h;
-
-        if (w <= 0 || h <= 0 || (x + w) <= 0 || (y + h) <= 0)
+        if (!ClipRect(this, &job->rects[i], top, bottom, &rect))
             continue;
 
-        if (x < 0)
+        if (this->hidden->upload_surface)
         {
-            x += w;
-            w += rects[i].x;
+            SDL_LowerBlit(SDL_VideoSurface, &rect, this->hidden->upload_surface, &rect);
+            continue;
         }
-        if (y < 0)
+
+        s_dest = region->vaddr + rect.y * d_stride + (rect.x * bytes_per_pixel);
+        pixels = (char*)SDL_VideoSurface->pixels + rect.y * s_stride + (rect.x * bytes_per_pixel);
+
+        Mir_CopyRows(s_dest, d_stride, pixels, s_stride, bytes_per_pixel * rect.w, rect.h);
+    }
+}
+
+void PutPixels(_THIS, int numrects, const SDL_Rect* const rects, const MirGraphicsRegion* region)
+{
+    struct UploadJob job = { numrects, rects, region };
+    SDL_Surface* target = this->hidden->upload_surface;
+    int i, pixels = 0;
+
+    if (target)
+    {
+        target->pixels = region->vaddr;
+        target->pitch  = region->stride;
+
+        // Set up the blit map here so the upload threads only ever read it
+        if (SDL_VideoSurface->map->dst != target ||
+            target->format_version != SDL_VideoSurface->map->format_version)
         {
-            y += h;
-            h += rects[i].y;
+            if (SDL_MapSurface(SDL_VideoSurface, target) < 0)
+                return;
         }
+    }
 
-        if (x + w > SDL_VideoSurface->w)
-            w = SDL_VideoSurface->w - x;
-        if (y + h > SDL_VideoSurface->h)
-            h = SDL_VideoSurface->h - y;
-
-        start = y * s_stride + (x * bytes_per_pixel);
-        pixels += start;
-        s_dest += start;
+    if (this->hidden->upload_threads)
+    {
+        for (i = 0; i < numrects; ++i)
+            pixels += rects[i].w * rects[i].h;
 
-        bytes_per_row =  bytes_per_pixel * w;
-        for (j = 0; j < h; j++)
+        if (pixels >= MIN_THREADED_UPLOAD_PIXELS)
         {
-            memcpy(s_dest, pixels, bytes_per_row);
-            pixels += s_stride;
-            s_dest += d_stride;
+            Mir_RunBands(this->hidden->upload_threads, SDL_VideoSurface->h, UploadBand, &job);
+            return;
         }
     }
+
+    UploadBand(this, 0, SDL_VideoSurface->h, &job);
 }
 
 void RedrawRegion(_THIS, const MirGraphicsRegion* region)
 {
-    int h;
+    SDL_Rect rect = { 0, 0, SDL_VideoSurface->w, SDL_VideoSurface->h };
 
-    int d_stride = region->stride;
-    int s_stride = SDL_VideoSurface->pitch;
-
-    char* dest = region->vaddr;
-    char* src  = (char*)SDL_VideoSurface->pixels;
-
-    int bytes_per_pixel = SDL_VideoSurface->format->BytesPerPixel;
-    int bytes_per_row =  bytes_per_pixel * SDL_VideoSurface->w;
-    for (h = 0; h < SDL_VideoSurface->h; h++)
-    {
-        memcpy(dest, src, bytes_per_row);
-        dest += d_stride;
-        src += s_stride;
-    }
+    PutPixels(this, 1, &rect, region);
 }
 
 SDL_Rect* DeepCopyRects(int numrects, const SDL_Rect* const rects)
@@ -102,35 +159,31 @@ SDL_Rect* DeepCopyRects(int numrects, const SDL_Rect* const rects)
 // If one of our frames in the queue is an exact match, just use that pointer
 SDL_Rect* FindDuplicateRects(const struct Queue* const queue, int numrects, const SDL_Rect* const rects)
 {
-    int n;
     int i;
     int match;
 
     struct QueueNode* node = NULL;
 
-    for (n = 0; n < numrects; n++)
+    for (node = queue->head.tqh_first; node != NULL; node = node->entries.tqe_next)
     {
-        for (node = queue->head.tqh_first; node != NULL; node = node->entries.tqe_next)
+        match = 1;
+        if (node->num == numrects)
         {
-            match = 1;
-            if (node->num == numrects)
+            for (i = 0; i < numrects; i++)
             {
-                for (i = 0; i < numrects; i++)
+                if (node->rects[i].x != rects[i].x ||
+                    node->rects[i].y != rects[i].y ||
+                    node->rects[i].w != rects[i].w ||
+                    node->rects[i].h != rects[i].h)
                 {
-                    if (node->rects[i].x != rects[i].x ||
-                        node->rects[i].y != rects[i].y ||
-                        node->rects[i].w != rects[i].w ||
-                        node->rects[i].h != rects[i].h)
-                    {
-                        match = 0;
-                        break;
-                    }
+                    match = 0;
+                    break;
                 }
+            }
 
-                if (match)
-                {
-                    return node->rects;
-                }
+            if (match)
+            {
+                return node->rects;
             }
         }
     }
@@ -184,6 +237,45 @@ void DeleteQueueNode(struct Queue* queue, struct QueueNode* queue_node)
     SDL_free(queue_node);
 }
 
+static void SwapBuffersCallback(MirSurface* surface, void* context)
+{
+    struct SDL_PrivateVideoData* hidden = context;
+
+    SDL_mutexP(hidden->swap_lock);
+    hidden->swap_pending = SDL_FALSE;
+    SDL_CondSignal(hidden->swap_cond);
+    SDL_mutexV(hidden->swap_lock);
+}
+
+// Mir only hands us the next buffer once the previous swap completes, so
+// this has to be called before touching the graphics region or the surface.
+void Mir_WaitForSwap(_THIS)
+{
+    if (!this->hidden->async_swap)
+        return;
+
+    SDL_mutexP(this->hidden->swap_lock);
+    while (this->hidden->swap_pending)
+        SDL_CondWait(this->hidden->swap_cond, this->hidden->swap_lock);
+    SDL_mutexV(this->hidden->swap_lock);
+}
+
+void Mir_SwapBuffers(_THIS)
+{
+    if (this->hidden->async_swap)
+    {
+        SDL_mutexP(this->hidden->swap_lock);
+        this->hidden->swap_pending = SDL_TRUE;
+        SDL_mutexV(this->hidden->swap_lock);
+
+        mir_surface_swap_buffers(this->hidden->surface, SwapBuffersCallback, this->hidden);
+    }
+    else
+    {
+        mir_surface_swap_buffers_sync(this->hidden->surface);
+    }
+}
+
 void Mir_UpdateRects(_THIS, int numrects, SDL_Rect* rects)
 {
     if (!mir_surface_is_valid(this->hidden->surface))
@@ -193,6 +285,8 @@ void Mir_UpdateRects(_THIS, int numrects, SDL_Rect* rects)
           return;
     }
 
+    Mir_WaitForSwap(this);
+
     MirGraphicsRegion region;
     mir_surface_get_graphics_region(this->hidden->surface, &region);
 
@@ -200,22 +294,33 @@ void Mir_UpdateRects(_THIS, int numrects, SDL_Rect* rects)
     mir_surface_get_current_buffer(this->hidden->surface, &buffer);
 
     struct Queue* queue = this->hidden->buffer_queue;
+    struct DamageRegion* damage = this->hidden->damage_region;
     struct QueueNode* node;
     int age = buffer->age;
+    int failed;
 
     if (age > 0)
     {
-        PutPixels(this, numrects, rects, &region);
+        // Merge the damage of the frames this buffer missed so each pixel is copied once
+        Mir_RegionClear(damage);
+        failed = Mir_RegionAddRects(damage, numrects, rects,
+                                    SDL_VideoSurface->w, SDL_VideoSurface->h);
         node = queue->head.tqh_first;
 
         while (age >= 0 && node != NULL)
         {
-            PutPixels(this, node->num, node->rects, &region);
+            failed |= Mir_RegionAddRects(damage, node->num, node->rects,
+                                         SDL_VideoSurface->w, SDL_VideoSurface->h);
 
             node = node->entries.tqe_next;
             age--;
         }
 
+        if (failed || Mir_RegionCoalesce(damage) < 0)
+            RedrawRegion(this, &region);
+        else
+            PutPixels(this, damage->num, damage->rects, &region);
+
         DeleteQueueNode(queue, queue->head.tqh_first);
 
         InsertNewQueueNode(queue, numrects, rects);
@@ -227,7 +332,59 @@ void Mir_UpdateRects(_THIS, int numrects, SDL_Rect* rects)
         InsertNewQueueNode(queue, numrects, rects);
     }
 
-    mir_surface_swap_buffers_sync(this->hidden->surface);
+    Mir_SwapBuffers(this);
+}
+
+void Mir_InitAsyncSwap(_THIS)
+{
+    const char* env = SDL_getenv("SDL_MIR_ASYNC_SWAP");
+
+    this->hidden->async_swap = SDL_FALSE;
+    this->hidden->swap_pending = SDL_FALSE;
+
+    if (!env || SDL_atoi(env) == 0)
+        return;
+
+    this->hidden->swap_lock = SDL_CreateMutex();
+    this->hidden->swap_cond = SDL_CreateCond();
+
+    // Fall back to sync swaps if we can't track the pending one
+    if (this->hidden->swap_lock && this->hidden->swap_cond)
+        this->hidden->async_swap = SDL_TRUE;
+    else
+        Mir_DeleteAsyncSwap(this);
+}
+
+void Mir_DeleteAsyncSwap(_THIS)
+{
+    Mir_WaitForSwap(this);
+    this->hidden->async_swap = SDL_FALSE;
+
+    if (this->hidden->swap_cond)
+    {
+        SDL_DestroyCond(this->hidden->swap_cond);
+        this->hidden->swap_cond = NULL;
+    }
+
+    if (this->hidden->swap_lock)
+    {
+        SDL_DestroyMutex(this->hidden->swap_lock);
+        this->hidden->swap_lock = NULL;
+    }
+}
+
+void Mir_InitUploadThreads(_THIS)
+{
+    const char* env = SDL_getenv("SDL_MIR_UPLOAD_THREADS");
+    int num_threads = env ? SDL_atoi(env) : 0;
+
+    this->hidden->upload_threads = Mir_CreateWorkerPool(this, SDL_min(num_threads, 64));
+}
+
+void Mir_DeleteUploadThreads(_THIS)
+{
+    Mir_DeleteWorkerPool(this->hidden->upload_threads);
+    this->hidden->upload_threads = NULL;
 }
 
 void Mir_InitQueue(struct Queue* const queue)
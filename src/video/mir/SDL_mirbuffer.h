@@ -34,6 +34,12 @@ struct Queue {
 };
 
 extern void Mir_UpdateRects(_THIS, int numrects, SDL_Rect* rects);
+extern void Mir_WaitForSwap(_THIS);
+extern void Mir_SwapBuffers(_THIS);
+extern void Mir_InitAsyncSwap(_THIS);
+extern void Mir_DeleteAsyncSwap(_THIS);
+extern void Mir_InitUploadThreads(_THIS);
+extern void Mir_DeleteUploadThreads(_THIS);
 extern void Mir_InitQueue(struct Queue* const queue);
 extern void Mir_DeleteQueue(struct Queue* const queue);
 
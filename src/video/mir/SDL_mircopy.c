@@ -0,0 +1,207 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 2013 Canonical Ltd
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Brandon Schaefer
+    brandon.schaefer@canonical.com
+*/
+
+#include "SDL_mircopy.h"
+#include "SDL_cpuinfo.h"
+
+#if SDL_ASSEMBLY_ROUTINES && defined(__SSE2__)
+#define MIR_SSE2_COPY
+#include <emmintrin.h>
+#endif
+
+#if SDL_ASSEMBLY_ROUTINES && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#define MIR_NEON_COPY
+#include <arm_neon.h>
+#endif
+
+// Rows shorter than this go through memcpy, the SIMD setup isn't worth it
+#define MIN_SIMD_ROW 256
+
+// Streaming stores only pay off for full width copies too big to stay in
+// the cache anyway. Smaller damage keeps the lines the compositor reads next.
+#define MIN_STREAM_COPY (256 * 1024)
+
+// When both strides match we copy the gap between rows too, as long as it
+// is small, so the whole block goes out in one copy.
+#define MAX_BULK_GAP 64
+
+typedef void (*CopyRowFunc)(char* dest, const char* src, int len);
+
+static void CopyRowMemcpy(char* dest, const char* src, int len)
+{
+    memcpy(dest, src, len);
+}
+
+#ifdef MIR_SSE2_COPY
+// Stores are aligned once the destination is, and bypass the cache with
+// streaming stores when 'stream' is set.
+static __inline__ void CopyRowSSE2Impl(char* dest, const char* src, int len, int stream)
+{
+    int head = (16 - ((uintptr_t)dest & 15)) & 15;
+
+    if (head > len)
+        head = len;
+
+    memcpy(dest, src, head);
+    dest += head;
+    src  += head;
+    len  -= head;
+
+    while (len >= 64)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i*)src);
+        __m128i b = _mm_loadu_si128((const __m128i*)(src + 16));
+        __m128i c = _mm_loadu_si128((const __m128i*)(src + 32));
+        __m128i d = _mm_loadu_si128((const __m128i*)(src + 48));
+
+        if (stream)
+        {
+            _mm_stream_si128((__m128i*)dest, a);
+            _mm_stream_si128((__m128i*)(dest + 16), b);
+            _mm_stream_si128((__m128i*)(dest + 32), c);
+            _mm_stream_si128((__m128i*)(dest + 48), d);
+        }
+        else
+        {
+            _mm_store_si128((__m128i*)dest, a);
+            _mm_store_si128((__m128i*)(dest + 16), b);
+            _mm_store_si128((__m128i*)(dest + 32), c);
+            _mm_store_si128((__m128i*)(dest + 48), d);
+        }
+
+        dest += 64;
+        src  += 64;
+        len  -= 64;
+    }
+
+    while (len >= 16)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i*)src);
+
+        if (stream)
+            _mm_stream_si128((__m128i*)dest, a);
+        else
+            _mm_store_si128((__m128i*)dest, a);
+
+        dest += 16;
+        src  += 16;
+        len  -= 16;
+    }
+
+    memcpy(dest, src, len);
+}
+
+static void CopyRowSSE2(char* dest, const char* src, int len)
+{
+    CopyRowSSE2Impl(dest, src, len, 0);
+}
+
+// Nothing reads the Mir buffer back on the CPU, so large copies bypass the cache
+static void CopyRowStreamSSE2(char* dest, const char* src, int len)
+{
+    CopyRowSSE2Impl(dest, src, len, 1);
+}
+#endif // MIR_SSE2_COPY
+
+#ifdef MIR_NEON_COPY
+static void CopyRowNEON(char* dest, const char* src, int len)
+{
+    while (len >= 64)
+    {
+        uint8x16_t a = vld1q_u8((const uint8_t*)src);
+        uint8x16_t b = vld1q_u8((const uint8_t*)(src + 16));
+        uint8x16_t c = vld1q_u8((const uint8_t*)(src + 32));
+        uint8x16_t d = vld1q_u8((const uint8_t*)(src + 48));
+
+        vst1q_u8((uint8_t*)dest, a);
+        vst1q_u8((uint8_t*)(dest + 16), b);
+        vst1q_u8((uint8_t*)(dest + 32), c);
+        vst1q_u8((uint8_t*)(dest + 48), d);
+
+        dest += 64;
+        src  += 64;
+        len  -= 64;
+    }
+
+    memcpy(dest, src, len);
+}
+#endif // MIR_NEON_COPY
+
+static CopyRowFunc copy_row = CopyRowMemcpy;
+static CopyRowFunc copy_row_stream = CopyRowMemcpy;
+
+void Mir_InitCopyRows(void)
+{
+    copy_row = CopyRowMemcpy;
+
+#ifdef MIR_SSE2_COPY
+    if (SDL_HasSSE2())
+        copy_row = CopyRowSSE2;
+#endif
+
+#ifdef MIR_NEON_COPY
+    copy_row = CopyRowNEON;
+#endif
+
+    copy_row_stream = copy_row;
+
+#ifdef MIR_SSE2_COPY
+    if (SDL_HasSSE2())
+        copy_row_stream = CopyRowStreamSSE2;
+#endif
+}
+
+void Mir_CopyRows(char* dest, int d_stride, const char* src, int s_stride,
+                  int bytes_per_row, int rows)
+{
+    int j;
+    int full_width = (d_stride - bytes_per_row <= MAX_BULK_GAP);
+    CopyRowFunc copy = copy_row;
+
+    if (rows <= 0 || bytes_per_row <= 0)
+        return;
+
+    if (full_width && bytes_per_row * rows >= MIN_STREAM_COPY)
+        copy = copy_row_stream;
+
+    if (s_stride == d_stride && s_stride - bytes_per_row <= MAX_BULK_GAP)
+    {
+        bytes_per_row += (rows - 1) * s_stride;
+        rows = 1;
+    }
+
+    if (bytes_per_row < MIN_SIMD_ROW)
+        copy = CopyRowMemcpy;
+
+    for (j = 0; j < rows; j++)
+    {
+        copy(dest, src, bytes_per_row);
+        src  += s_stride;
+        dest += d_stride;
+    }
+
+#ifdef MIR_SSE2_COPY
+    // Make the streamed rows visible before the buffer is handed to Mir
+    if (copy == CopyRowStreamSSE2)
+        _mm_sfence();
+#endif
+}
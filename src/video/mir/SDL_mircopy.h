@@ -0,0 +1,34 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 2013 Canonical Ltd
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Brandon Schaefer
+    brandon.schaefer@canonical.com
+*/
+
+#include "SDL_config.h"
+
+#ifndef _SDL_mircopy_h
+#define _SDL_mircopy_h
+
+#include "SDL_stdinc.h"
+
+extern void Mir_InitCopyRows(void);
+extern void Mir_CopyRows(char* dest, int d_stride, const char* src, int s_stride,
+                         int bytes_per_row, int rows);
+
+#endif // _SDL_mircopy_h
@@ -24,9 +24,29 @@
 
 #include "../../events/SDL_events_c.h"
 #include <xkbcommon/xkbcommon.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
 #define MIN_KEYCODE 8
 
+// Mir delivers events on its own IPC thread. They are copied into this
+// single producer/single consumer ring and handed to SDL from
+// Mir_PumpEvents on the app thread, so the two never fight over the
+// SDL event queue lock.
+#define EVENT_RING_SIZE 1024
+#define EVENT_RING_MASK (EVENT_RING_SIZE - 1)
+
+static MirEvent event_ring[EVENT_RING_SIZE];
+static unsigned int event_ring_head; // Only written by the Mir thread
+static unsigned int event_ring_tail; // Only written by the app thread
+
+// Bumped by the Mir thread for every event it pushes, so SDL_WaitEvent can
+// sleep in poll() on it rather than waking up to check the ring
+static int event_ring_fd = -1;
+
+// Set SDL_MIR_COALESCE_MOTION=1 to fold runs of pointer moves into one
+static SDL_bool coalesce_motion;
+
 static SDLKey MISC_keymap[256];
 
 void Mir_InitKeymap()
@@ -129,6 +149,49 @@ void Mir_InitOSKeymap(_THIS)
     Mir_InitKeymap();
 }
 
+void Mir_InitEventRing(void)
+{
+    const char* env = SDL_getenv("SDL_MIR_COALESCE_MOTION");
+
+    event_ring_head = 0;
+    event_ring_tail = 0;
+
+    coalesce_motion = (env && SDL_atoi(env)) ? SDL_TRUE : SDL_FALSE;
+
+    if (event_ring_fd < 0)
+        event_ring_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+}
+
+void Mir_DeleteEventRing(void)
+{
+    if (event_ring_fd >= 0)
+    {
+        close(event_ring_fd);
+        event_ring_fd = -1;
+    }
+}
+
+int Mir_GetEventFD(_THIS, int* timeout)
+{
+    return event_ring_fd;
+}
+
+static SDL_bool IsPointerMove(MirEvent const* event)
+{
+    return event->type == mir_event_type_motion &&
+           (event->motion.action == mir_motion_action_move ||
+            event->motion.action == mir_motion_action_hover_move);
+}
+
+// A move can be dropped when the next event is a move with the same buttons
+// held. SDL works out the relative motion from the last absolute position,
+// so the deltas of the dropped moves end up in the one we keep.
+static SDL_bool CanCoalesce(MirEvent const* event, MirEvent const* next)
+{
+    return IsPointerMove(event) && IsPointerMove(next) &&
+           event->motion.button_state == next->motion.button_state;
+}
+
 void HandleMouseButton(Uint8 state, MirMotionButton button_state)
 {
     static uint32_t last_sdl_button;
@@ -226,18 +289,80 @@ void Mir_HandleKeyEvent(MirSurface const* surface, MirKeyEvent const* key_event)
     SDL_PrivateKeyboard(key_state, &keysym);
 }
 
-void Mir_HandleSurfaceEvent(MirSurface* surface,
-                            MirEvent const* event, void* context)
+static void Mir_DispatchEvent(MirEvent const* event)
 {
     switch (event->type)
     {
         case(mir_event_type_key):
-            Mir_HandleKeyEvent(surface, &event->key);
+            Mir_HandleKeyEvent(NULL, &event->key);
             break;
         case(mir_event_type_motion):
-            Mir_HandleMotionEvent(surface, &event->motion);
+            Mir_HandleMotionEvent(NULL, &event->motion);
             break;
         default:
             break;
     }
 }
+
+void Mir_HandleSurfaceEvent(MirSurface* surface,
+                            MirEvent const* event, void* context)
+{
+    unsigned int head, tail;
+
+    if (event->type != mir_event_type_key && event->type != mir_event_type_motion)
+        return;
+
+    head = event_ring_head;
+    tail = __atomic_load_n(&event_ring_tail, __ATOMIC_ACQUIRE);
+
+    // Full means the app stopped pumping, the SDL queue is far smaller anyway
+    if (head - tail == EVENT_RING_SIZE)
+        return;
+
+    event_ring[head & EVENT_RING_MASK] = *event;
+    __atomic_store_n(&event_ring_head, head + 1, __ATOMIC_RELEASE);
+
+    if (event_ring_fd >= 0)
+    {
+        uint64_t one = 1;
+        if (write(event_ring_fd, &one, sizeof one) < 0)
+        {
+            // Only fails if the counter is saturated, it is readable then
+        }
+    }
+}
+
+void Mir_PumpEvents(_THIS)
+{
+    unsigned int tail, head;
+
+    // Reset the wakeup before looking at the ring, so a push that races
+    // with the drain below leaves the fd readable
+    if (event_ring_fd >= 0)
+    {
+        uint64_t count;
+        if (read(event_ring_fd, &count, sizeof count) < 0)
+        {
+            // EAGAIN, nothing was pushed since the last pump
+        }
+    }
+
+    tail = event_ring_tail;
+    head = __atomic_load_n(&event_ring_head, __ATOMIC_ACQUIRE);
+
+    while (tail != head)
+    {
+        MirEvent const* event = &event_ring[tail & EVENT_RING_MASK];
+        ++tail;
+
+        if (coalesce_motion && tail != head &&
+            CanCoalesce(event, &event_ring[tail & EVENT_RING_MASK]))
+        {
+            continue;
+        }
+
+        Mir_DispatchEvent(event);
+    }
+
+    __atomic_store_n(&event_ring_tail, tail, __ATOMIC_RELEASE);
+}
@@ -27,6 +27,10 @@
 #include "SDL_mirvideo.h"
 
 extern void Mir_InitOSKeymap(_THIS);
+extern void Mir_InitEventRing(void);
+extern void Mir_DeleteEventRing(void);
+extern int  Mir_GetEventFD(_THIS, int* timeout);
+extern void Mir_PumpEvents(_THIS);
 extern void Mir_HandleSurfaceEvent(MirSurface* surface,
                                    MirEvent const* event, void* context);
 
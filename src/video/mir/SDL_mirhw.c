@@ -20,7 +20,67 @@
     brandon.schaefer@canonical.com
 */
 
+#include "SDL_video.h"
+#include "../SDL_pixels_c.h"
+
 #include "SDL_mirhw.h"
+#include "SDL_mirbuffer.h"
+
+// Points the screen at the buffer we are allowed to draw into next
+void Mir_GetDirectBuffer(_THIS, SDL_Surface* surface)
+{
+    MirGraphicsRegion region;
+
+    Mir_WaitForSwap(this);
+    mir_surface_get_graphics_region(this->hidden->surface, &region);
+
+    surface->pixels = region.vaddr;
+    surface->pitch  = region.stride;
+}
+
+// Double buffered modes are shown with SDL_Flip. Apps that show them with
+// SDL_UpdateRect(s) instead expect the screen to keep what they drew between
+// updates, which swapping buffers can't give them, so the first such call
+// moves the screen to a shadow buffer that Mir_UpdateRects uploads from then on.
+void Mir_DirectUpdateRects(_THIS, int numrects, SDL_Rect* rects)
+{
+    SDL_Surface* screen = SDL_VideoSurface;
+    Uint8 *pixels, *src, *dst;
+    int pitch, row, y;
+
+    if (!this->hidden->direct_render || screen == NULL)
+        return;
+
+    pitch  = SDL_CalculatePitch(screen);
+    pixels = SDL_malloc(screen->h * pitch);
+    if (!pixels)
+    {
+        SDL_OutOfMemory();
+        return;
+    }
+
+    // Keep what the app has drawn into the current buffer so far
+    Mir_GetDirectBuffer(this, screen);
+
+    src = screen->pixels;
+    dst = pixels;
+    row = screen->w * screen->format->BytesPerPixel;
+    for (y = 0; y < screen->h; y++)
+    {
+        SDL_memcpy(dst, src, row);
+        src += screen->pitch;
+        dst += pitch;
+    }
+
+    screen->pixels = pixels;
+    screen->pitch  = pitch;
+    screen->flags &= ~(SDL_HWSURFACE | SDL_DOUBLEBUF);
+
+    this->hidden->direct_render = SDL_FALSE;
+    this->UpdateRects = Mir_UpdateRects;
+
+    Mir_UpdateRects(this, numrects, rects);
+}
 
 int Mir_AllocHWSurface(_THIS, SDL_Surface* surface)
 {
@@ -33,6 +93,9 @@ void Mir_FreeHWSurface(_THIS, SDL_Surface* surface)
 
 int Mir_LockHWSurface(_THIS, SDL_Surface* surface)
 {
+    if (this->hidden->direct_render && surface == SDL_VideoSurface)
+        Mir_GetDirectBuffer(this, surface);
+
     return 0;
 }
 
@@ -42,5 +105,21 @@ void Mir_UnlockHWSurface(_THIS, SDL_Surface* surface)
 
 int Mir_FlipHWSurface(_THIS, SDL_Surface* surface)
 {
+    if (!this->hidden->direct_render)
+        return 0;
+
+    if (!mir_surface_is_valid(this->hidden->surface))
+    {
+        SDL_SetError("Failed to created a mir surface: %s",
+                     mir_surface_get_error_message(this->hidden->surface));
+        return -1;
+    }
+
+    Mir_SwapBuffers(this);
+
+    // With async swaps the next lock waits for the new buffer instead
+    if (!this->hidden->async_swap)
+        Mir_GetDirectBuffer(this, surface);
+
     return 0;
 }
@@ -32,5 +32,7 @@ extern void Mir_FreeHWSurface(_THIS, SDL_Surface* surface);
 extern int Mir_LockHWSurface(_THIS, SDL_Surface* surface);
 extern void Mir_UnlockHWSurface(_THIS, SDL_Surface* surface);
 extern int Mir_FlipHWSurface(_THIS, SDL_Surface* surface);
+extern void Mir_GetDirectBuffer(_THIS, SDL_Surface* surface);
+extern void Mir_DirectUpdateRects(_THIS, int numrects, SDL_Rect* rects);
 
 #endif //_SDL_mirhw_h
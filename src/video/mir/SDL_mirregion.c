@@ -0,0 +1,284 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 2013 Canonical Ltd
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Brandon Schaefer
+    brandon.schaefer@canonical.com
+*/
+
+#include "SDL_mirregion.h"
+
+static int CompareBoxTop(const void* a, const void* b)
+{
+    return ((const struct RegionBox*)a)->y1 - ((const struct RegionBox*)b)->y1;
+}
+
+static int CompareBoxLeft(const void* a, const void* b)
+{
+    return ((const struct RegionBox*)a)->x1 - ((const struct RegionBox*)b)->x1;
+}
+
+static int CompareEdge(const void* a, const void* b)
+{
+    return *(const int*)a - *(const int*)b;
+}
+
+void Mir_InitRegion(struct DamageRegion* const region)
+{
+    SDL_memset(region, 0, sizeof(struct DamageRegion));
+}
+
+void Mir_DeleteRegion(struct DamageRegion* const region)
+{
+    SDL_free(region->rects);
+    SDL_free(region->boxes);
+    SDL_free(region->edges);
+    SDL_free(region->active);
+    SDL_free(region->spans);
+
+    Mir_InitRegion(region);
+}
+
+void Mir_RegionClear(struct DamageRegion* const region)
+{
+    region->num = 0;
+    region->num_boxes = 0;
+}
+
+// Clips the rects to a w x h surface and queues them up for the next coalesce
+int Mir_RegionAddRects(struct DamageRegion* const region, int numrects,
+                       const SDL_Rect* const rects, int w, int h)
+{
+    int i;
+    struct RegionBox* box;
+
+    if (region->num_boxes + numrects > region->boxes_size)
+    {
+        int new_size = SDL_max(region->boxes_size * 2, region->num_boxes + numrects);
+        struct RegionBox* new_boxes = SDL_realloc(region->boxes,
+                                                  new_size * sizeof(struct RegionBox));
+        if (!new_boxes)
+        {
+            SDL_OutOfMemory();
+            return -1;
+        }
+
+        region->boxes = new_boxes;
+        region->boxes_size = new_size;
+    }
+
+    for (i = 0; i < numrects; i++)
+    {
+        box = &region->boxes[region->num_boxes];
+
+        box->x1 = SDL_max(rects[i].x, 0);
+        box->y1 = SDL_max(rects[i].y, 0);
+        box->x2 = SDL_min(rects[i].x + rects[i].w, w);
+        box->y2 = SDL_min(rects[i].y + rects[i].h, h);
+
+        if (box->x1 < box->x2 && box->y1 < box->y2)
+            region->num_boxes++;
+    }
+
+    return 0;
+}
+
+static int ReserveScratch(struct DamageRegion* const region, int num_boxes)
+{
+    int* new_edges;
+    struct RegionBox** new_active;
+    struct RegionBox* new_spans;
+
+    if (num_boxes <= region->scratch_size)
+        return 0;
+
+    new_edges = SDL_realloc(region->edges, 2 * num_boxes * sizeof(int));
+    if (new_edges)
+        region->edges = new_edges;
+
+    new_active = SDL_realloc(region->active, num_boxes * sizeof(struct RegionBox*));
+    if (new_active)
+        region->active = new_active;
+
+    new_spans = SDL_realloc(region->spans, num_boxes * sizeof(struct RegionBox));
+    if (new_spans)
+        region->spans = new_spans;
+
+    if (!new_edges || !new_active || !new_spans)
+    {
+        SDL_OutOfMemory();
+        return -1;
+    }
+
+    region->scratch_size = num_boxes;
+    return 0;
+}
+
+static int ReserveRects(struct DamageRegion* const region, int num)
+{
+    SDL_Rect* new_rects;
+    int new_size;
+
+    if (num <= region->rects_size)
+        return 0;
+
+    new_size = SDL_max(region->rects_size * 2, num);
+    new_rects = SDL_realloc(region->rects, new_size * sizeof(SDL_Rect));
+    if (!new_rects)
+    {
+        SDL_OutOfMemory();
+        return -1;
+    }
+
+    region->rects = new_rects;
+    region->rects_size = new_size;
+    return 0;
+}
+
+// Sorts x spans and merges the ones that overlap or touch, returns the count
+static int MergeSpans(struct RegionBox* spans, int num)
+{
+    int i, merged = 0;
+
+    SDL_qsort(spans, num, sizeof(struct RegionBox), CompareBoxLeft);
+
+    for (i = 1; i < num; i++)
+    {
+        if (spans[i].x1 <= spans[merged].x2)
+        {
+            if (spans[i].x2 > spans[merged].x2)
+                spans[merged].x2 = spans[i].x2;
+        }
+        else
+        {
+            spans[++merged] = spans[i];
+        }
+    }
+
+    return merged + 1;
+}
+
+// Turns every box added since the last clear into a set of non-overlapping
+// rects in region->rects. Returns -1 when out of memory.
+int Mir_RegionCoalesce(struct DamageRegion* const region)
+{
+    int i, e, num_edges, num_active, num_spans, next_box;
+    int band_top, band_bottom;
+    int prev_start = 0, prev_num = 0, prev_bottom = -1;
+    SDL_bool same_spans;
+
+    struct RegionBox* boxes = region->boxes;
+    int num_boxes = region->num_boxes;
+
+    region->num = 0;
+
+    if (num_boxes == 0)
+        return 0;
+
+    if (ReserveScratch(region, num_boxes) < 0)
+        return -1;
+
+    SDL_qsort(boxes, num_boxes, sizeof(struct RegionBox), CompareBoxTop);
+
+    for (i = 0; i < num_boxes; i++)
+    {
+        region->edges[2 * i]     = boxes[i].y1;
+        region->edges[2 * i + 1] = boxes[i].y2;
+    }
+
+    SDL_qsort(region->edges, 2 * num_boxes, sizeof(int), CompareEdge);
+
+    num_edges = 1;
+    for (i = 1; i < 2 * num_boxes; i++)
+    {
+        if (region->edges[i] != region->edges[num_edges - 1])
+            region->edges[num_edges++] = region->edges[i];
+    }
+
+    num_active = 0;
+    next_box = 0;
+
+    for (e = 0; e + 1 < num_edges; e++)
+    {
+        band_top    = region->edges[e];
+        band_bottom = region->edges[e + 1];
+
+        // Every box starts and ends on an edge, so an active box covers the whole band
+        for (i = 0; i < num_active; )
+        {
+            if (region->active[i]->y2 <= band_top)
+                region->active[i] = region->active[--num_active];
+            else
+                i++;
+        }
+
+        while (next_box < num_boxes && boxes[next_box].y1 <= band_top)
+        {
+            region->active[num_active++] = &boxes[next_box];
+            next_box++;
+        }
+
+        if (num_active == 0)
+        {
+            prev_num = 0;
+            continue;
+        }
+
+        for (i = 0; i < num_active; i++)
+            region->spans[i] = *region->active[i];
+
+        num_spans = MergeSpans(region->spans, num_active);
+
+        same_spans = (prev_num == num_spans && prev_bottom == band_top);
+        for (i = 0; same_spans && i < num_spans; i++)
+        {
+            const SDL_Rect* prev = &region->rects[prev_start + i];
+            if (prev->x != region->spans[i].x1 ||
+                prev->w != region->spans[i].x2 - region->spans[i].x1)
+            {
+                same_spans = SDL_FALSE;
+            }
+        }
+
+        if (same_spans)
+        {
+            for (i = 0; i < num_spans; i++)
+                region->rects[prev_start + i].h += band_bottom - band_top;
+        }
+        else
+        {
+            if (ReserveRects(region, region->num + num_spans) < 0)
+                return -1;
+
+            prev_start = region->num;
+            prev_num = num_spans;
+
+            for (i = 0; i < num_spans; i++)
+            {
+                SDL_Rect* rect = &region->rects[region->num++];
+                rect->x = region->spans[i].x1;
+                rect->y = band_top;
+                rect->w = region->spans[i].x2 - region->spans[i].x1;
+                rect->h = band_bottom - band_top;
+            }
+        }
+
+        prev_bottom = band_bottom;
+    }
+
+    return 0;
+}
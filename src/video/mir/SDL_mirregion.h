@@ -0,0 +1,62 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 2013 Canonical Ltd
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Brandon Schaefer
+    brandon.schaefer@canonical.com
+*/
+
+#include "SDL_config.h"
+
+#ifndef _SDL_mirregion_h
+#define _SDL_mirregion_h
+
+#include "SDL_video.h"
+
+struct RegionBox
+{
+    int x1, y1, x2, y2;
+};
+
+// A banded set of non-overlapping rects, built the same way pixman regions
+// are: rects are sorted into horizontal bands sharing the same y range, and
+// vertically adjacent bands with the same x spans are merged together.
+struct DamageRegion
+{
+    SDL_Rect* rects;
+    int num;
+    int rects_size;
+
+    // Scratch space reused between frames so coalescing does not allocate
+    struct RegionBox* boxes;
+    int num_boxes;
+    int boxes_size;
+
+    int* edges;
+    struct RegionBox** active;
+    struct RegionBox* spans;
+    int scratch_size;
+};
+
+extern void Mir_InitRegion(struct DamageRegion* const region);
+extern void Mir_DeleteRegion(struct DamageRegion* const region);
+extern void Mir_RegionClear(struct DamageRegion* const region);
+extern int Mir_RegionAddRects(struct DamageRegion* const region, int numrects,
+                              const SDL_Rect* const rects, int w, int h);
+extern int Mir_RegionCoalesce(struct DamageRegion* const region);
+
+#endif // _SDL_mirregion_h
@@ -0,0 +1,172 @@
+/*
+    SDL - Simple DirectMedia Layer
+    Copyright (C) 2013 Canonical Ltd
+
+    This library is free software; you can redistribute it and/or
+    modify it under the terms of the GNU Lesser General Public
+    License as published by the Free Software Foundation; either
+    version 2.1 of the License, or (at your option) any later version.
+
+    This library is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+    Lesser General Public License for more details.
+
+    You should have received a copy of the GNU Lesser General Public
+    License along with this library; if not, write to the Free Software
+    Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+    Brandon Schaefer
+    brandon.schaefer@canonical.com
+*/
+
+#include "SDL_mirthreads.h"
+
+#include "SDL_thread.h"
+
+struct Worker
+{
+    struct WorkerPool* pool;
+    SDL_Thread* thread;
+    SDL_sem* start;
+
+    int top;
+    int bottom;
+};
+
+struct WorkerPool
+{
+    SDL_VideoDevice* device;
+
+    // The calling thread takes the first band, so this is num_threads - 1
+    int num_workers;
+    struct Worker* workers;
+    SDL_sem* done;
+
+    BandFunc func;
+    void* data;
+    SDL_bool quit;
+};
+
+static int WorkerThread(void* data)
+{
+    struct Worker* worker = data;
+    struct WorkerPool* pool = worker->pool;
+
+    for (;;)
+    {
+        SDL_SemWait(worker->start);
+
+        if (pool->quit)
+            break;
+
+        pool->func(pool->device, worker->top, worker->bottom, pool->data);
+        SDL_SemPost(pool->done);
+    }
+
+    return 0;
+}
+
+struct WorkerPool* Mir_CreateWorkerPool(_THIS, int num_threads)
+{
+    int i;
+    struct WorkerPool* pool;
+
+    if (num_threads < 2)
+        return NULL;
+
+    pool = SDL_calloc(1, sizeof(struct WorkerPool));
+    if (!pool)
+    {
+        SDL_OutOfMemory();
+        return NULL;
+    }
+
+    pool->device = this;
+    pool->workers = SDL_calloc(num_threads - 1, sizeof(struct Worker));
+    pool->done = SDL_CreateSemaphore(0);
+
+    if (!pool->workers || !pool->done)
+    {
+        Mir_DeleteWorkerPool(pool);
+        return NULL;
+    }
+
+    for (i = 0; i < num_threads - 1; i++)
+    {
+        struct Worker* worker = &pool->workers[i];
+
+        worker->pool = pool;
+        worker->start = SDL_CreateSemaphore(0);
+        if (!worker->start)
+            break;
+
+        worker->thread = SDL_CreateThread(WorkerThread, worker);
+        if (!worker->thread)
+        {
+            SDL_DestroySemaphore(worker->start);
+            worker->start = NULL;
+            break;
+        }
+
+        pool->num_workers++;
+    }
+
+    // Not worth it if we couldn't get a single extra thread going
+    if (pool->num_workers == 0)
+    {
+        Mir_DeleteWorkerPool(pool);
+        return NULL;
+    }
+
+    return pool;
+}
+
+void Mir_DeleteWorkerPool(struct WorkerPool* pool)
+{
+    int i;
+
+    if (!pool)
+        return;
+
+    pool->quit = SDL_TRUE;
+
+    for (i = 0; i < pool->num_workers; i++)
+    {
+        SDL_SemPost(pool->workers[i].start);
+        SDL_WaitThread(pool->workers[i].thread, NULL);
+        SDL_DestroySemaphore(pool->workers[i].start);
+    }
+
+    if (pool->done)
+        SDL_DestroySemaphore(pool->done);
+
+    SDL_free(pool->workers);
+    SDL_free(pool);
+}
+
+// Splits the rows into one band per thread and blocks until all are done
+void Mir_RunBands(struct WorkerPool* pool, int height, BandFunc func, void* data)
+{
+    int i, band_height;
+
+    band_height = (height + pool->num_workers) / (pool->num_workers + 1);
+
+    pool->func = func;
+    pool->data = data;
+
+    for (i = 0; i < pool->num_workers; i++)
+    {
+        struct Worker* worker = &pool->workers[i];
+
+        worker->top    = SDL_min((i + 1) * band_height, height);
+        worker->bottom = SDL_min((i + 2) * band_height, height);
+
+        SDL_SemPost(worker->start);
+    }
+
+    func(pool->device, 0, SDL_min(band_height, height), data);
+
+    for (i = 0; i < pool->num_workers; i++)
+        SDL_SemWait(pool->done);
+}
@@ -28,10 +28,12 @@
 #include "../SDL_sysvideo.h"
 
 #include "SDL_mirbuffer.h"
+#include "SDL_mircopy.h"
 #include "SDL_mirevents.h"
 #include "SDL_mirgl.h"
 #include "SDL_mirhw.h"
 #include "SDL_mirmouse.h"
+#include "SDL_mirregion.h"
 #include "SDL_mirvideo.h"
 
 static int Mir_VideoInit(_THIS, SDL_PixelFormat* vformat);
@@ -49,10 +51,6 @@ static int Mir_Available(void)
     return 1;
 }
 
-void Mir_PumpEvents(_THIS)
-{
-}
-
 static int Mir_ToggleFullScreen(_THIS, int on)
 {
     if (!mir_surface_is_valid(this->hidden->surface))
@@ -130,6 +128,14 @@ static SDL_VideoDevice* Mir_CreateDevice(int devindex)
         return 0;
     }
 
+    device->hidden->damage_region = SDL_calloc(1, sizeof(struct DamageRegion));
+    if (!device->hidden->damage_region)
+    {
+        Mir_DeleteDevice(device);
+        SDL_OutOfMemory();
+        return 0;
+    }
+
     device->hidden->connection = NULL;
     device->hidden->surface = NULL;
 
@@ -178,6 +184,7 @@ static SDL_VideoDevice* Mir_CreateDevice(int devindex)
 #endif // SDL_VIDEO_OPENGL
 
     device->PumpEvents = Mir_PumpEvents;
+    device->GetEventFD = Mir_GetEventFD;
 
     return device;
 }
@@ -187,9 +194,96 @@ VideoBootStrap Mir_bootstrap = {
     Mir_Available, Mir_CreateDevice
 };
 
+static void Mir_GetFormatMasks(MirPixelFormat format, Uint32* Rmask,
+                               Uint32* Gmask, Uint32* Bmask, Uint32* Amask)
+{
+    *Rmask = *Gmask = *Bmask = *Amask = 0;
+
+    switch (format)
+    {
+        case(mir_pixel_format_abgr_8888):
+            *Amask = 0xFF000000;
+            // Fall through
+        case(mir_pixel_format_xbgr_8888):
+        case(mir_pixel_format_bgr_888):
+            *Rmask = 0x000000FF;
+            *Gmask = 0x0000FF00;
+            *Bmask = 0x00FF0000;
+            break;
+        case(mir_pixel_format_argb_8888):
+            *Amask = 0xFF000000;
+            // Fall through
+        case(mir_pixel_format_xrgb_8888):
+            *Rmask = 0x00FF0000;
+            *Gmask = 0x0000FF00;
+            *Bmask = 0x000000FF;
+            break;
+        default:
+            break;
+    }
+}
+
+static void Mir_FreeUploadSurface(_THIS)
+{
+    if (this->hidden->upload_surface)
+    {
+        SDL_FreeSurface(this->hidden->upload_surface);
+        this->hidden->upload_surface = NULL;
+    }
+}
+
+// Uses the Mir format for the screen unless the app asked for another
+// packed pixel depth, in which case Mir_UpdateRects converts on upload.
+static int Mir_SetSurfaceFormat(_THIS, SDL_Surface* current, int bpp)
+{
+    Uint32 Rmask, Gmask, Bmask, Amask;
+    int mir_bpp = MIR_BYTES_PER_PIXEL(this->hidden->pixel_format) * 8;
+
+    Mir_GetFormatMasks(this->hidden->pixel_format, &Rmask, &Gmask, &Bmask, &Amask);
+    Mir_FreeUploadSurface(this);
+
+    if (bpp > 8 && bpp != mir_bpp)
+    {
+        MirGraphicsRegion region;
+        mir_surface_get_graphics_region(this->hidden->surface, &region);
+
+        // Wraps the Mir buffer so the SDL blitters can write into it
+        this->hidden->upload_surface =
+            SDL_CreateRGBSurfaceFrom(region.vaddr, region.width, region.height,
+                                     mir_bpp, region.stride,
+                                     Rmask, Gmask, Bmask, Amask);
+        if (!this->hidden->upload_surface)
+            return -1;
+
+        Rmask = Gmask = Bmask = 0;
+    }
+    else
+    {
+        bpp = mir_bpp;
+    }
+
+    if (current->format->BitsPerPixel == bpp &&
+        current->format->Rmask == Rmask &&
+        current->format->Gmask == Gmask &&
+        current->format->Bmask == Bmask)
+    {
+        return 0;
+    }
+
+    if (!SDL_ReallocFormat(current, bpp, Rmask, Gmask, Bmask, 0))
+    {
+        Mir_FreeUploadSurface(this);
+        return -1;
+    }
+
+    return 0;
+}
+
 SDL_Surface* Mir_SetVideoMode(_THIS, SDL_Surface* current,
                               int width, int height, int bpp, Uint32 flags)
 {
+    Mir_WaitForSwap(this);
+
     if (this->hidden->surface && mir_surface_is_valid(this->hidden->surface))
     {
          mir_surface_release_sync(this->hidden->surface);
@@ -364,6 +458,13 @@ SDL_Surface* Mir_SetVideoMode(_THIS, SDL_Surface* current,
 
     if (flags & SDL_OPENGL)
     {
+        if (this->hidden->direct_render)
+        {
+            this->hidden->direct_render = SDL_FALSE;
+            current->flags &= ~(SDL_HWSURFACE | SDL_DOUBLEBUF);
+            current->pixels = NULL;
+        }
+
         current->flags |= SDL_OPENGL;
 
         if (Mir_GL_CreateESurface(this) < 0)
@@ -378,10 +479,47 @@ SDL_Surface* Mir_SetVideoMode(_THIS, SDL_Surface* current,
             return NULL;
         }
     }
+    else if ((flags & (SDL_HWSURFACE | SDL_DOUBLEBUF)) == (SDL_HWSURFACE | SDL_DOUBLEBUF))
+    {
+        // No shadow buffer, the app draws into the Mir buffer and SDL_Flip swaps.
+        // Calling SDL_UpdateRect(s) instead drops back to a shadow buffer.
+        if (!this->hidden->direct_render)
+            SDL_free(current->pixels);
+
+        current->pixels = NULL;
+        if (Mir_SetSurfaceFormat(this, current, 0) < 0)
+            return NULL;
+
+        current->flags |= SDL_HWSURFACE | SDL_DOUBLEBUF;
+        current->w      = width;
+        current->h      = height;
+
+        this->hidden->direct_render = SDL_TRUE;
+        Mir_GetDirectBuffer(this, current);
+
+        this->UpdateRects = Mir_DirectUpdateRects;
+    }
     else
     {
-        if ((current->w != width || current->h != height))
+        int old_pitch = current->pitch;
+
+        if (this->hidden->direct_render)
         {
+            this->hidden->direct_render = SDL_FALSE;
+            current->flags &= ~(SDL_HWSURFACE | SDL_DOUBLEBUF);
+            current->pixels = NULL;
+        }
+
+        // Keep the bpp the app asked for and convert while uploading, rather
+        // than having SDL blit a shadow surface into ours every frame.
+        if (Mir_SetSurfaceFormat(this, current, bpp) < 0)
+            return NULL;
+
+        if (!current->pixels || current->w != width || current->h != height ||
+            SDL_CalculatePitch(current) != old_pitch)
+        {
+            SDL_free(current->pixels);
+
             current->pixels = NULL;
             current->w      = width;
             current->h      = height;
@@ -393,8 +531,9 @@ SDL_Surface* Mir_SetVideoMode(_THIS, SDL_Surface* current,
                   SDL_OutOfMemory();
                   return NULL;
             }
-            this->UpdateRects = Mir_UpdateRects;
         }
+
+        this->UpdateRects = Mir_UpdateRects;
     }
 
     return current;
@@ -491,10 +630,19 @@ int Mir_VideoInit(_THIS, SDL_PixelFormat *vformat)
         return -1;
     }
 
+    Uint32 Amask;
+
     this->hidden->pixel_format = formats[0];
     vformat->BitsPerPixel = MIR_BYTES_PER_PIXEL(this->hidden->pixel_format) * 8;
+    Mir_GetFormatMasks(this->hidden->pixel_format, &vformat->Rmask,
+                       &vformat->Gmask, &vformat->Bmask, &Amask);
 
     Mir_InitQueue(this->hidden->buffer_queue);
+    Mir_InitRegion(this->hidden->damage_region);
+    Mir_InitAsyncSwap(this);
+    Mir_InitCopyRows();
+    Mir_InitUploadThreads(this);
+    Mir_InitEventRing();
     Mir_ModeListUpdate(this);
     mir_connection_set_display_config_change_callback(this->hidden->connection,
                                                       Mir_DisplayConfigChanged, this);
@@ -515,12 +663,31 @@ void Mir_VideoQuit(_THIS)
         SDL_free(this->hidden->buffer_queue);
     }
 
+    if (this->hidden->damage_region)
+    {
+        Mir_DeleteRegion(this->hidden->damage_region);
+        SDL_free(this->hidden->damage_region);
+    }
+
+    Mir_DeleteAsyncSwap(this);
+    Mir_DeleteUploadThreads(this);
+    Mir_FreeUploadSurface(this);
+
+    // The screen pixels belong to the Mir buffer, don't let SDL free them
+    if (this->hidden->direct_render && this->screen)
+    {
+        this->screen->pixels = NULL;
+        this->hidden->direct_render = SDL_FALSE;
+    }
+
     if (this->hidden->surface)
     {
         mir_surface_release_sync(this->hidden->surface);
         this->hidden->surface = NULL;
     }
 
+    Mir_DeleteEventRing();
+
 #if SDL_VIDEO_OPENGL
     if (this->gl_config.driver_loaded != 0)
     {
@@ -25,6 +25,7 @@
 #ifndef _SDL_mirvideo_h
 #define _SDL_mirvideo_h
 
+#include "SDL_mutex.h"
 #include "../SDL_sysvideo.h"
 
 #include <mir_toolkit/mir_client_library.h>
@@ -37,6 +38,24 @@ struct SDL_PrivateVideoData {
     MirPixelFormat pixel_format;
 
     struct Queue* buffer_queue;
+    struct DamageRegion* damage_region;
+
+    // Async swaps: the game thread only blocks on the compositor when it
+    // needs to write into the next buffer while the last swap is pending.
+    SDL_bool async_swap;
+    SDL_bool swap_pending;
+    SDL_mutex* swap_lock;
+    SDL_cond* swap_cond;
+
+    // SDL_HWSURFACE|SDL_DOUBLEBUF modes draw straight into the Mir buffer,
+    // until the app shows them with SDL_UpdateRect(s) rather than SDL_Flip
+    SDL_bool direct_render;
+
+    // Wraps the Mir buffer when the screen has a different bpp than Mir
+    SDL_Surface* upload_surface;
+
+    // Splits large uploads into bands, set with SDL_MIR_UPLOAD_THREADS
+    struct WorkerPool* upload_threads;
 
     SDL_bool mode_changed;
     SDL_Rect** modelist;
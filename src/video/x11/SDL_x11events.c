@@ -913,6 +913,28 @@ int X11_Pending(Display *display)
 	return(0);
 }
 
+static void X11_LowerTimeout(int *timeout, int when)
+{
+	if ( when < 0 ) {
+		when = 0;
+	}
+	if ( (*timeout < 0) || (when < *timeout) ) {
+		*timeout = when;
+	}
+}
+
+int X11_GetEventFD(_THIS, int *timeout)
+{
+	/* Pending fullscreen switches and the screensaver need a pump */
+	if ( switch_waiting ) {
+		X11_LowerTimeout(timeout, (int)(switch_time-SDL_GetTicks()));
+	}
+	if ( !allow_screensaver ) {
+		X11_LowerTimeout(timeout, 5000);
+	}
+	return(ConnectionNumber(SDL_Display));
+}
+
 void X11_PumpEvents(_THIS)
 {
 	int pending;
@@ -26,4 +26,5 @@
 /* Functions to be exported */
 extern void X11_InitOSKeymap(_THIS);
 extern void X11_PumpEvents(_THIS);
+extern int X11_GetEventFD(_THIS, int *timeout);
 extern void X11_SetKeyboardState(Display *display, const char *key_vec);
@@ -0,0 +1,87 @@
+/* Sanity checks on resampling with SDL_ConvertAudio() */
+
+#include <stdio.h>
+
+#include "SDL.h"
+
+#define FRAMES	4096
+
+/* Resample FRAMES frames of full-scale 16-bit audio alternating between
+   'hi' and 'lo', and return the number of frames converted, or -1.
+*/
+static int Resample(int src_rate, int dst_rate, int channels,
+                    Sint16 hi, Sint16 lo, Sint16 **out)
+{
+	SDL_AudioCVT cvt;
+	Sint16 *samples;
+	int i;
+
+	if ( SDL_BuildAudioCVT(&cvt, AUDIO_S16SYS, channels, src_rate,
+	                       AUDIO_S16SYS, channels, dst_rate) < 0 ) {
+		return(-1);
+	}
+	cvt.len = FRAMES * channels * sizeof(Sint16);
+	cvt.buf = (Uint8 *)SDL_malloc(cvt.len * cvt.len_mult);
+	if ( cvt.buf == NULL ) {
+		return(-1);
+	}
+	samples = (Sint16 *)cvt.buf;
+	for ( i=0; i<FRAMES*channels; ++i ) {
+		samples[i] = ((i / channels) & 1) ? lo : hi;
+	}
+	if ( SDL_ConvertAudio(&cvt) < 0 ) {
+		SDL_free(cvt.buf);
+		return(-1);
+	}
+	*out = samples;
+	return(cvt.len_cvt / (channels * sizeof(Sint16)));
+}
+
+/* Interpolation is linear, so full-scale input must come out as twice
+   the half-scale one, give or take the rounding of each.
+*/
+static int TestFullScale(int src_rate, int dst_rate, int channels)
+{
+	Sint16 *full, *half;
+	int frames, i, error;
+
+	error = 0;
+	frames = Resample(src_rate, dst_rate, channels, 32767, -32768, &full);
+	if ( (frames < 0) ||
+	     (Resample(src_rate, dst_rate, channels, 16383, -16384, &half) != frames) ) {
+		printf("Couldn't resample %d to %d Hz: %s\n",
+		       src_rate, dst_rate, SDL_GetError());
+		return(1);
+	}
+	for ( i=0; i<frames*channels; ++i ) {
+		if ( SDL_abs(full[i] - 2*half[i]) > 2 ) {
+			printf("%d to %d Hz, %d channels: sample %d is %d, expected about %d\n",
+			       src_rate, dst_rate, channels, i, full[i], 2*half[i]);
+			error = 1;
+			break;
+		}
+	}
+	SDL_free(full);
+	SDL_free(half);
+	if ( ! error ) {
+		printf("%d to %d Hz, %d channels: passed\n",
+		       src_rate, dst_rate, channels);
+	}
+	return(error);
+}
+
+int main(int argc, char *argv[])
+{
+	int status = 0;
+
+	if ( SDL_Init(0) < 0 ) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		return(1);
+	}
+	status |= TestFullScale(44100, 48000, 1);
+	status |= TestFullScale(44100, 48000, 2);
+	status |= TestFullScale(48000, 44100, 2);
+	status |= TestFullScale(22050, 48000, 6);
+	SDL_Quit();
+	return(status);
+}